@@ -25,33 +25,88 @@ unsigned __int32 getSizeOfAdvancedValueType(std::vector<unsigned __int8>& buffer
 	}
 };
 
-unsigned __int8 getSizeOfFundamentalValueType(pyeValueType valueType) {
+unsigned __int64 getOffsetValueEnd(const PyeByteSpan& buffer, unsigned __int64 offsetValue) {
+	unsigned __int64 idx = offsetValue;
+
+	unsigned __int8 valueType;
+	ReadFromVector(valueType, buffer, idx);
+
+	idx += sizeof(valueType);
+
 	switch (valueType) {
-	case pyeValueType::pyeZero:		// pyeZero; -
-		return -1;
-	case pyeValueType::pyeBool:		// pyeBool; -
-		return -1;
-	case pyeValueType::pyeInt8:		// pyeInt8; 1 Byte
-	case pyeValueType::pyeUInt8:	// pyeUInt8; 1 Byte
-		return 1;
-	case pyeValueType::pyeInt16:	// pyeInt16; 2 Byte
-	case pyeValueType::pyeUInt16:	// pyeUInt16; 2 Byte 
-		return 2;
-	case pyeValueType::pyeInt32:	// pyeInt32; 4 Byte
-	case pyeValueType::pyeUInt32:	// pyeUInt32; 4 Byte 
-	case pyeValueType::pyeFloat32:	// pyeFloat32; 4 Byte 
-		return 4;
-	case pyeValueType::pyeInt64:	// pyeInt64; 8 Byte
-	case pyeValueType::pyeUInt64:	// pyeUInt64; 8 Byte
-	case pyeValueType::pyeFloat64:	// pyeFloat64; 8 Byte
-		return 8;
-	case pyeValueType::pyeInt128:	// pyeInt128; 16 Byte
-	case pyeValueType::pyeUInt128:	// pyeUInt128; 16 Byte
-	case pyeValueType::pyeFloat128:	// pyeFloat128; 16 Byte
-		return 16;
+	case 20u:	// pyeArray; UInt32 Size + UInt32 Count
+		idx += 1; /*info data type of array items*/
+	case 1u:	// pyeList; UInt32 Size + UInt32 Count
+		unsigned __int32 listLength;
+		ReadFromVector(listLength, buffer, idx);
+		idx += sizeof(listLength);
+		idx += 4; /*info count of items*/
+		idx += listLength;
+		break;
+	case 2u:	// pyeZero; -
+	case 3u:	// pyeBool; -
+		break;
+	case 4u:	// pyeInt8; 1 Byte
+	case 5u:	// pyeUInt8; 1 Byte
+		idx += 1;
+		break;
+	case 6u:	// pyeInt16; 2 Byte
+	case 7u:	// pyeUInt16; 2 Byte
+		idx += 2;
+		break;
+	case 8u:	// pyeInt32; 4 Byte
+	case 9u:	// pyeUInt32; 4 Byte
+	case 14u:	// pyeFloat32; 4 Byte
+		idx += 4;
+		break;
+	case 10u:	// pyeInt64; 8 Byte
+	case 11u:	// pyeUInt64; 8 Byte
+	case 15u:	// pyeFloat64; 8 Byte
+		idx += 8;
+		break;
+	case 12u:	// pyeInt128; 16 Byte
+	case 13u:	// pyeUInt128; 16 Byte
+	case 16u:	// pyeFloat128; 16 Byte
+		idx += 16;
+		break;
+	case 17u:	// pyeStringUTF8S; UInt8 as char count
+		unsigned __int8 stringLength;
+		ReadFromVector(stringLength, buffer, idx);
+		idx += sizeof(stringLength);
+		idx += stringLength;
+		break;
+	case 18u:	// pyeStringUTF8L; UInt32 as char count
+	case 19u:	// pyeMemory; UInt32 size of mem
+		unsigned __int32 dataLength;
+		ReadFromVector(dataLength, buffer, idx);
+		idx += sizeof(dataLength);
+		idx += dataLength;
+		break;
+	case 21u:	// pyeArrayMap; UInt16 map length + map + UInt32 Size + UInt32 Count
+	case 22u:	// pyeColumnMap; UInt16 map length + map + UInt32 Size + UInt32 Count
+		unsigned __int16 mapLength;
+		ReadFromVector(mapLength, buffer, idx);
+		idx += sizeof(mapLength);
+		idx += mapLength;
+
+		unsigned __int32 mapSize;
+		ReadFromVector(mapSize, buffer, idx);
+		idx += sizeof(mapSize);
+		idx += 4; /*count of items*/
+		idx += mapSize;
+		break;
 	default: // type: 0
-		return -1;
+		break;
 	}
+
+	return idx;
+};
+
+unsigned __int64 getOffsetObjectEnd(const PyeByteSpan& buffer, unsigned __int64 offsetObject) {
+	unsigned __int8 keySize;
+	ReadFromVector(keySize, buffer, offsetObject);
+
+	return getOffsetValueEnd(buffer, offsetObject + 1 /*information key size*/ + keySize);
 };
 
 PyeArray::PyeArray(PyeList* pLastList, pyeValueType arrayType, unsigned __int64 offsetObjectStart) {
@@ -151,4 +206,153 @@ void PyeArrayMap::updateObjectHeader() {
 	if (_pLastList) {
 		_pLastList->updateObjectHeader();
 	}
-}
\ No newline at end of file
+}
+
+/* PyeColumnMap
+Name			type			size in byte	usage
+pyeColumnMap	pyeValueType	1				Value=22
+MapLength		UInt16			2				length of the MapStruct; Number of columns
+MapStruct		pyeValueType	MapLength		pyeValueType and their order of the columns; 1 Byte per value type
+Size			UInt32			4				size of value data of complete pyeColumnMap
+Count			UInt32			4				count of items (rows)
+Offsets			UInt32			4*MapLength		offset of the values of every column
+*/
+PyeColumnMap::PyeColumnMap(PyeList* pLastList, std::vector<pyeValueType> mapStruct, unsigned __int64 offsetObjectStart) {
+	_pLastList = pLastList;
+	setBuffer(_pLastList->getBuffer());
+	setOffsetObject(offsetObjectStart);
+
+	unsigned __int8 _type = pyeValueType::pyeColumnMap;
+	WriteToVector(*getBuffer(), _type, (*getBuffer()).size());
+
+	unsigned __int16 mapLength = (unsigned __int16)mapStruct.size();
+	WriteToVector(*getBuffer(), mapLength, (*getBuffer()).size());
+
+	for (unsigned __int8 type : mapStruct) {
+		WriteToVector(*getBuffer(), type, (*getBuffer()).size());
+	}
+
+	unsigned __int32 _mapSize = 0;
+	WriteToVector(*getBuffer(), _mapSize, (*getBuffer()).size());
+
+	unsigned __int32 _mapCount = 0;
+	WriteToVector(*getBuffer(), _mapCount, (*getBuffer()).size());
+
+	// all columns are empty
+	unsigned __int32 _offsetColumn = 0;
+	for (unsigned __int16 i = 0; i < mapLength; i++) {
+		WriteToVector(*getBuffer(), _offsetColumn, (*getBuffer()).size());
+	}
+
+	// update size information in header of recent list
+	updateObjectHeader();
+
+	// update size information in header of document
+	updateHeaderSize();
+}
+
+void PyeColumnMap::updateObjectHeader() {
+	std::vector<unsigned char>& buffer = *getBuffer();
+	unsigned __int16 mapLength = getMapLength();
+
+	unsigned __int64 offsetColumnTable = getOffsetValue();
+	offsetColumnTable += 1; /* information about pye value type (uint8) */
+	offsetColumnTable += 2; /* information about pye map length (uint16) */
+	offsetColumnTable += mapLength;
+	offsetColumnTable += 4; /* information about map size (uint32) */
+	offsetColumnTable += 4; /* information about map item count (uint32) */
+
+	// the value of a single put is written to the end of the byte stream, the end of the last column;
+	// it is moved to the end of its column and the following columns are shifted
+	if (_offsetPutValue > 0 && mapLength > 0) {
+		unsigned __int16 column = (unsigned __int16)((_cntItemsAll - 1) % mapLength);
+
+		if (column + 1 < mapLength) {
+			unsigned __int32 sizeValue = (unsigned __int32)(buffer.size() - _offsetPutValue);
+			unsigned __int64 offsetColumnEnd = getOffsetColumn(column + 1);
+
+			std::rotate(buffer.begin() + offsetColumnEnd, buffer.begin() + _offsetPutValue, buffer.end());
+
+			for (unsigned __int16 i = column + 1; i < mapLength; i++) {
+				unsigned __int32 offsetColumn;
+				ReadFromVector(offsetColumn, buffer, offsetColumnTable + 4 * (unsigned __int64)i);
+				offsetColumn += sizeValue;
+				WriteToVector(buffer, offsetColumn, offsetColumnTable + 4 * (unsigned __int64)i);
+			}
+		}
+	}
+	_offsetPutValue = 0;
+
+	unsigned __int32 mapSize = (unsigned __int32)(buffer.size() - offsetColumnTable);
+	WriteToVector(buffer, mapSize, getOffsetValue() + 1 /*pye value type*/ + 2 /*pye map length*/ + mapLength);
+
+	unsigned __int32 cntItems = 0;
+	if (mapLength > 0) {
+		cntItems = (unsigned __int32)(_cntItemsAll / mapLength); // count only full/complete items
+	}
+	WriteToVector(buffer, cntItems, getOffsetValue() + 7 /*pyeValueType(1 byte) + information length of map (2 byte) + mapSize(4 byte)*/ + mapLength);
+
+	if (_pLastList) {
+		_pLastList->updateObjectHeader();
+	}
+}
+
+PyeColumnMap& PyeColumnMap::putColumns(const std::vector<std::vector<unsigned char>>& columnData, unsigned __int32 countRows) {
+	std::vector<unsigned char>& buffer = *getBuffer();
+	unsigned __int16 mapLength = getMapLength();
+
+	if (columnData.size() != mapLength || mapLength == 0) {
+		return *this;
+	}
+
+	unsigned __int64 offsetColumnTable = getOffsetValue() + 11 /*column map header*/ + mapLength;
+	unsigned __int64 offsetFirstColumn = offsetColumnTable + 4 * (unsigned __int64)mapLength;
+
+	// the columns are rebuilt with the new values at the end of every column
+	std::vector<unsigned __int64> offsetColumns;
+	for (unsigned __int16 i = 0; i < mapLength; i++) {
+		offsetColumns.push_back(getOffsetColumn(i));
+	}
+	offsetColumns.push_back(buffer.size());
+
+	unsigned __int64 sizeColumns = buffer.size() - offsetFirstColumn;
+	for (const std::vector<unsigned char>& data : columnData) {
+		sizeColumns += data.size();
+	}
+
+	std::vector<unsigned char> columns;
+	columns.reserve(sizeColumns);
+
+	for (unsigned __int16 i = 0; i < mapLength; i++) {
+		unsigned __int32 offsetColumn = (unsigned __int32)columns.size();
+		WriteToVector(buffer, offsetColumn, offsetColumnTable + 4 * (unsigned __int64)i);
+
+		columns.insert(columns.end(), buffer.begin() + offsetColumns[i], buffer.begin() + offsetColumns[i + 1]);
+		columns.insert(columns.end(), columnData[i].begin(), columnData[i].end());
+	}
+
+	buffer.resize(offsetFirstColumn);
+	buffer.insert(buffer.end(), columns.begin(), columns.end());
+	_cntItemsAll += (unsigned __int64)countRows * mapLength;
+
+	updateObjectHeader();
+	updateHeaderSize();
+
+	return *this;
+}
+
+PyeColumnMap& PyeColumnMap::putRows(const std::vector<unsigned char>& rowData, unsigned __int32 countRows) {
+	std::vector<pyeValueType> mapStruct = getMapStruct();
+	std::vector<std::vector<unsigned char>> columnData(mapStruct.size());
+
+	unsigned __int64 offset = 0;
+	for (unsigned __int32 i = 0; i < countRows; i++) {
+		for (size_t j = 0; j < mapStruct.size(); j++) {
+			unsigned __int64 size = getSizeOfValueData(rowData, offset, mapStruct[j]);
+			columnData[j].insert(columnData[j].end(), rowData.begin() + offset, rowData.begin() + offset + size);
+			offset += size;
+		}
+	}
+
+	return putColumns(columnData, countRows);
+}
@@ -52,18 +52,13 @@
 #include <stdint.h>
 #include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
 
 #pragma once
 
 #define DATASIZE 1024 
 
-/// <summary> Typedef for 128-bit integer </summary>
-typedef std::vector<unsigned char> int128;
-/// <summary> Typedef for 128-bit unsigned integer </summary>
-typedef std::vector<unsigned char> uInt128;
-/// <summary> Typedef for 128-bit float </summary>
-typedef std::vector<unsigned char> float128;
-
 
 /// <summary>
 /// Several string components for printing formatted pyeKVS on the screen.
@@ -85,9 +80,75 @@ const char Str_PYEKVSUnknown[] = "Unknown value type";
 const char Str_PYEKVSZero = '0';
 const char Str_PYEKVSBool = '1';
 
+/// <summary>
+/// Reserved keys start with a null character. Reserved objects are written by extensions
+/// of the library, e.g. the key directory of a list, and describe their own list.
+/// </summary>
+const char Str_PYEKVSReservedKeyPrefix = '\0';
+
+/// <summary>
+/// Checks if a key is a reserved key.
+/// </summary>
+/// <param name="key">key name</param>
+/// <returns>true, if the key starts with the reserved key prefix</returns>
+inline bool pyeIsReservedKey(const std::string& key) {
+	return !key.empty() && key[0] == Str_PYEKVSReservedKeyPrefix;
+}
+
+/// <summary>
+/// Interned keys are 3 bytes: the prefix and the id (uint16) of the key in the key dictionary of the document.
+/// The prefix is reserved like the prefix of the reserved keys: a key of 3 bytes with the prefix is always an interned key.
+/// Key names with the prefix are escaped by PyeKey, so they are never read as interned key.
+/// </summary>
+const char Str_PYEKVSInternedKeyPrefix = '\x01';
+
+/// <summary>
+/// Checks if a key is an interned key.
+/// </summary>
+/// <param name="key">key name</param>
+/// <returns>true, if the key is the id of a key in the key dictionary</returns>
+inline bool pyeIsInternedKey(const std::string& key) {
+	return key.size() == 3 && key[0] == Str_PYEKVSInternedKeyPrefix;
+}
+
+/// <summary>
+/// Gets the id of an interned key.
+/// </summary>
+/// <param name="key">interned key</param>
+/// <returns>id of the key in the key dictionary</returns>
+inline unsigned __int16 pyeInternedKeyId(const std::string& key) {
+	return (unsigned __int16)((unsigned __int8)key[1] | ((unsigned __int8)key[2] << 8));
+}
+
+/// <summary>
+/// Order of the keys in the index of a list: the interned keys first, compared by their ids,
+/// then all other keys compared as strings.
+/// </summary>
+struct PyeKeyLess {
+	bool operator()(const std::string& a, const std::string& b) const {
+		bool internedA = pyeIsInternedKey(a);
+		bool internedB = pyeIsInternedKey(b);
+		if (internedA != internedB) {
+			return internedA;
+		}
+		if (internedA) {
+			return pyeInternedKeyId(a) < pyeInternedKeyId(b);
+		}
+		return a < b;
+	}
+};
+
+/// <summary>
+/// Index of the items of a list: key and offset of the pyeKVS object in the byte stream.
+/// </summary>
+typedef std::map<std::string, unsigned __int64, PyeKeyLess> PyeItemIdx;
+
 /// <summary>
 /// Enum of pyeKVS value types
 /// see more: https://www.kxtec.de/project/pyekvs/pyekvs-specification/
+/// pyeColumnMap (22) is an extension of this implementation and not part of the specification 1.0,
+/// the header version stays 1.0. Readers of the specification see it as an unknown value type,
+/// documents without pyeColumnMap objects are unchanged.
 /// </summary>
 enum pyeValueType : unsigned __int8 {
 	pyeUnknown,
@@ -111,13 +172,14 @@ enum pyeValueType : unsigned __int8 {
 	pyeStringUTF8L,  // dynamic length; special header L-arge 4Byte char count + string as UTF8 chars; max 2147483647 chars
 	pyeMemory,       // dynamic length; special header 4Byte mem size + values as byte stream
 	pyeArray,        // dynamic length; special header 1Byte ValueType + 4Bytes Size + 4Bytes Count + values
-	pyeArrayMap      // dynamic length; special header 2Byte map length + map +  4Bytes Size + 4Bytes Count + values
+	pyeArrayMap,     // dynamic length; special header 2Byte map length + map +  4Bytes Size + 4Bytes Count + values
+	pyeColumnMap     // dynamic length; special header 2Byte map length + map +  4Bytes Size + 4Bytes Count + 4Bytes offset per column + values per column
 };
 
 /// <summary>
 /// Array of strings of pyeKVS value type names for messaging in the log
 /// </summary>
-const std::string pyeKVSValueTypeName[22] = {
+const std::string pyeKVSValueTypeName[23] = {
 	"Unknown",
 	"List",
 	"Zero",
@@ -139,7 +201,8 @@ const std::string pyeKVSValueTypeName[22] = {
 	"StringUTF8L",
 	"Memory",
 	"Array",
-	"ArrayMap"
+	"ArrayMap",
+	"ColumnMap"
 };
 
 /// <summary>
@@ -150,7 +213,7 @@ const std::string pyeKVSValueTypeName[22] = {
 /// <param name="v">Vector of bytes, where to read the byte sequence from</param>
 /// <param name="offset">Index, where to start to read from vector</param>
 template <class T>
-void ReadFromVector(T& t, std::vector<unsigned char>& v, std::size_t offset) {
+void ReadFromVector(T& t, const std::vector<unsigned char>& v, std::size_t offset) {
 	memcpy(&t, &v[offset], sizeof(T));
 };
 
@@ -171,6 +234,59 @@ void WriteToVector(std::vector<unsigned char>& v, T& t, std::size_t offset) {
 	memcpy(&v[offset], &t, sizeof(T));
 };
 
+/// <summary>
+/// Read-only range (pointer and length) of a pyeKVS byte stream in any memory, e.g. a network buffer,
+/// shared memory or a slot of a ring buffer. The bytes are not copied, the memory must outlive the span.
+/// A std::vector converts to a span of its bytes.
+/// </summary>
+class PyeByteSpan {
+	const unsigned char* _data = nullptr;
+	size_t _size = 0;
+
+public:
+	PyeByteSpan() {}
+
+	PyeByteSpan(const unsigned char* data, size_t size) : _data(data), _size(size) {}
+
+	PyeByteSpan(const std::vector<unsigned char>& buffer) : _data(buffer.data()), _size(buffer.size()) {}
+
+	const unsigned char* data() const {
+		return _data;
+	}
+
+	size_t size() const {
+		return _size;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+	const unsigned char& operator[](size_t idx) const {
+		return _data[idx];
+	}
+
+	const unsigned char* begin() const {
+		return _data;
+	}
+
+	const unsigned char* end() const {
+		return _data + _size;
+	}
+};
+
+/// <summary>
+/// Reads a byte sequence from a byte span.
+/// </summary>
+/// <typeparam name="T">Data type to read from span</typeparam>
+/// <param name="t">Reference, where to write the byte sequence to</param>
+/// <param name="v">Span of bytes, where to read the byte sequence from</param>
+/// <param name="offset">Index, where to start to read from span</param>
+template <class T>
+void ReadFromVector(T& t, const PyeByteSpan& v, std::size_t offset) {
+	memcpy(&t, &v[offset], sizeof(T));
+};
+
 /// <summary>
 /// Get the size of a advanced pyeKVS type. 
 /// </summary>
@@ -180,12 +296,320 @@ void WriteToVector(std::vector<unsigned char>& v, T& t, std::size_t offset) {
 /// <returns></returns>
 unsigned __int32 getSizeOfAdvancedValueType(std::vector<unsigned __int8>& buffer, unsigned __int64 offset, unsigned __int8 valueType);
 
+/// <summary>
+/// Size of the value data of the fundamental pyeKVS types in bytes, indexed by pyeValueType.
+/// Types without value data (pyeZero, pyeBool) and types with dynamic length have size 0.
+/// </summary>
+constexpr unsigned __int8 pyeSizeOfFundamentalValueType[23] = {
+	0,	// pyeUnknown
+	0,	// pyeList
+	0,	// pyeZero
+	0,	// pyeBool
+	1,	// pyeInt8
+	1,	// pyeUInt8
+	2,	// pyeInt16
+	2,	// pyeUInt16
+	4,	// pyeInt32
+	4,	// pyeUInt32
+	8,	// pyeInt64
+	8,	// pyeUInt64
+	16,	// pyeInt128
+	16,	// pyeUInt128
+	4,	// pyeFloat32
+	8,	// pyeFloat64
+	16,	// pyeFloat128
+	0,	// pyeStringUTF8S
+	0,	// pyeStringUTF8L
+	0,	// pyeMemory
+	0,	// pyeArray
+	0,	// pyeArrayMap
+	0	// pyeColumnMap
+};
+
 /// <summary>
 /// Get the size of a fundamental pyeKVS type. 
 /// </summary>
 /// <param name="valueType"></param>
-/// <returns></returns>
-unsigned __int8 getSizeOfFundamentalValueType(pyeValueType valueType);
+/// <returns>size of the value data; 0 for types without fixed size</returns>
+constexpr unsigned __int8 getSizeOfFundamentalValueType(pyeValueType valueType) {
+	return valueType < sizeof(pyeSizeOfFundamentalValueType) ? pyeSizeOfFundamentalValueType[valueType] : 0;
+}
+
+/// <summary>
+/// Gets the size of the value data of a pyeKVS value without pye value type, e.g. of an item of a pyeArray.
+/// </summary>
+/// <typeparam name="B">std::vector of bytes or PyeByteSpan</typeparam>
+/// <param name="buffer">byte stream</param>
+/// <param name="offset">offset of the value data</param>
+/// <param name="valueType">pye value type of the value</param>
+/// <returns>size in bytes including the length information of strings and memory</returns>
+template<class B>
+inline unsigned __int64 getSizeOfValueData(const B& buffer, unsigned __int64 offset, pyeValueType valueType) {
+	switch (valueType) {
+	case pyeValueType::pyeStringUTF8S:
+		return 1 /*UInt8 char count*/ + buffer[offset];
+	case pyeValueType::pyeStringUTF8L:
+	case pyeValueType::pyeMemory:
+		unsigned __int32 dataLength;
+		ReadFromVector(dataLength, buffer, offset);
+		return 4 /*UInt32 size*/ + dataLength;
+	default:
+		return getSizeOfFundamentalValueType(valueType);
+	}
+}
+
+/// <summary>
+/// Get the offset behind the last byte of a encoded pyeKVS value.
+/// </summary>
+/// <param name="buffer">pyeKVS byte stream</param>
+/// <param name="offsetValue">offset of the pye value type of the value</param>
+/// <returns>offset of the first byte behind the value</returns>
+unsigned __int64 getOffsetValueEnd(const PyeByteSpan& buffer, unsigned __int64 offsetValue);
+
+/// <summary>
+/// Get the offset behind the last byte of a encoded pyeKVS object (key and value).
+/// </summary>
+/// <param name="buffer">pyeKVS byte stream</param>
+/// <param name="offsetObject">offset of the key size of the object</param>
+/// <returns>offset of the first byte behind the object</returns>
+unsigned __int64 getOffsetObjectEnd(const PyeByteSpan& buffer, unsigned __int64 offsetObject);
+
+/// <summary>
+/// 128-bit value with 16 bytes (little endian), held inline without heap allocation.
+/// The value is trivially copyable and put to or read from the byte stream with one memcpy,
+/// e.g. for UUIDs and hashes. The compare operators compare the numeric value (high 64 bits first);
+/// float128 values are compared by sign and magnitude like the IEEE total order (-0 before +0, NaNs at the ends).
+/// </summary>
+/// <typeparam name="type">pye value type: pyeInt128, pyeUInt128 or pyeFloat128</typeparam>
+template<pyeValueType type>
+struct PyeValue128 {
+	/// <summary> Bytes of the value, little endian </summary>
+	unsigned char data[16] = {};
+
+	PyeValue128() = default;
+
+	/// <summary>
+	/// Constructor of a value of two 64-bit halves
+	/// </summary>
+	/// <param name="low">lower 64 bits</param>
+	/// <param name="high">upper 64 bits</param>
+	PyeValue128(unsigned __int64 low, unsigned __int64 high) {
+		memcpy(&data[0], &low, sizeof(low));
+		memcpy(&data[8], &high, sizeof(high));
+	}
+
+	unsigned __int64 getLow() const {
+		unsigned __int64 low;
+		memcpy(&low, &data[0], sizeof(low));
+		return low;
+	}
+
+	unsigned __int64 getHigh() const {
+		unsigned __int64 high;
+		memcpy(&high, &data[8], sizeof(high));
+		return high;
+	}
+
+	size_t size() const {
+		return sizeof(data);
+	}
+
+	unsigned char& operator[](size_t idx) {
+		return data[idx];
+	}
+
+	const unsigned char& operator[](size_t idx) const {
+		return data[idx];
+	}
+
+	const unsigned char* begin() const {
+		return data;
+	}
+
+	const unsigned char* end() const {
+		return data + sizeof(data);
+	}
+
+	bool operator==(const PyeValue128& other) const {
+		return getLow() == other.getLow() && getHigh() == other.getHigh();
+	}
+
+	bool operator!=(const PyeValue128& other) const {
+		return !(*this == other);
+	}
+
+	bool operator<(const PyeValue128& other) const {
+		if (type == pyeValueType::pyeFloat128) {
+			// sign and magnitude: the order of the negative values is reversed
+			bool negative = (getHigh() >> 63) != 0;
+			if (negative != ((other.getHigh() >> 63) != 0)) {
+				return negative;
+			}
+			return negative ? isLessUnsigned(other, *this) : isLessUnsigned(*this, other);
+		}
+
+		if (type == pyeValueType::pyeInt128 && getHigh() != other.getHigh()) {
+			// the sign of an int128 is in the upper 64 bits
+			return (__int64)getHigh() < (__int64)other.getHigh();
+		}
+		return isLessUnsigned(*this, other);
+	}
+
+	bool operator>(const PyeValue128& other) const {
+		return other < *this;
+	}
+
+	bool operator<=(const PyeValue128& other) const {
+		return !(other < *this);
+	}
+
+	bool operator>=(const PyeValue128& other) const {
+		return !(*this < other);
+	}
+
+private:
+	static bool isLessUnsigned(const PyeValue128& a, const PyeValue128& b) {
+		if (a.getHigh() != b.getHigh()) {
+			return a.getHigh() < b.getHigh();
+		}
+		return a.getLow() < b.getLow();
+	}
+};
+
+/// <summary> Typedef for 128-bit integer </summary>
+typedef PyeValue128<pyeValueType::pyeInt128> int128;
+/// <summary> Typedef for 128-bit unsigned integer </summary>
+typedef PyeValue128<pyeValueType::pyeUInt128> uInt128;
+/// <summary> Typedef for 128-bit float </summary>
+typedef PyeValue128<pyeValueType::pyeFloat128> float128;
+
+namespace std {
+	template<pyeValueType type>
+	struct hash<PyeValue128<type>> {
+		size_t operator()(const PyeValue128<type>& value) const {
+			unsigned __int64 h = value.getLow() ^ (value.getHigh() * 0x9E3779B97F4A7C15ULL);
+			h ^= h >> 32;
+			return (size_t)h;
+		}
+	};
+}
+
+/// <summary>
+/// Traits of a C++ type, which is stored as a pyeKVS value.
+/// A specialization gives the pye value type and the encoding of the value data.
+/// Further types can be added by user defined specializations.
+/// </summary>
+/// <typeparam name="T">C++ type of the value</typeparam>
+template<class T>
+struct PyeValueTypeTraits;
+
+/// <summary>
+/// Traits of the fundamental pyeKVS value types with fixed size.
+/// The value data is copied by memcpy (little endian).
+/// </summary>
+/// <typeparam name="T">C++ type of the value</typeparam>
+/// <typeparam name="type">pye value type</typeparam>
+template<class T, pyeValueType type>
+struct PyeFundamentalValueTypeTraits {
+	static_assert(sizeof(T) == pyeSizeOfFundamentalValueType[type], "size of the C++ type does not match the pye value type");
+
+	static const pyeValueType valueType = type;
+
+	static pyeValueType getValueType(const T& /*value*/) {
+		return type;
+	}
+
+	static void write(std::vector<unsigned char>& buffer, const T& value) {
+		WriteToVector(buffer, value, buffer.size());
+	}
+
+	static T read(const std::vector<unsigned char>& buffer, unsigned __int64 offset, pyeValueType /*storedType*/) {
+		T value;
+		ReadFromVector(value, buffer, offset);
+		return value;
+	}
+};
+
+template<> struct PyeValueTypeTraits<__int8> : PyeFundamentalValueTypeTraits<__int8, pyeValueType::pyeInt8> {};
+template<> struct PyeValueTypeTraits<__int16> : PyeFundamentalValueTypeTraits<__int16, pyeValueType::pyeInt16> {};
+template<> struct PyeValueTypeTraits<__int32> : PyeFundamentalValueTypeTraits<__int32, pyeValueType::pyeInt32> {};
+template<> struct PyeValueTypeTraits<__int64> : PyeFundamentalValueTypeTraits<__int64, pyeValueType::pyeInt64> {};
+template<> struct PyeValueTypeTraits<unsigned __int8> : PyeFundamentalValueTypeTraits<unsigned __int8, pyeValueType::pyeUInt8> {};
+template<> struct PyeValueTypeTraits<unsigned __int16> : PyeFundamentalValueTypeTraits<unsigned __int16, pyeValueType::pyeUInt16> {};
+template<> struct PyeValueTypeTraits<unsigned __int32> : PyeFundamentalValueTypeTraits<unsigned __int32, pyeValueType::pyeUInt32> {};
+template<> struct PyeValueTypeTraits<unsigned __int64> : PyeFundamentalValueTypeTraits<unsigned __int64, pyeValueType::pyeUInt64> {};
+template<> struct PyeValueTypeTraits<float> : PyeFundamentalValueTypeTraits<float, pyeValueType::pyeFloat32> {};
+template<> struct PyeValueTypeTraits<double> : PyeFundamentalValueTypeTraits<double, pyeValueType::pyeFloat64> {};
+template<> struct PyeValueTypeTraits<int128> : PyeFundamentalValueTypeTraits<int128, pyeValueType::pyeInt128> {};
+template<> struct PyeValueTypeTraits<uInt128> : PyeFundamentalValueTypeTraits<uInt128, pyeValueType::pyeUInt128> {};
+template<> struct PyeValueTypeTraits<float128> : PyeFundamentalValueTypeTraits<float128, pyeValueType::pyeFloat128> {};
+
+/// <summary>
+/// Traits of bool: true is stored as pyeBool, false as pyeZero, both without value data.
+/// </summary>
+template<> struct PyeValueTypeTraits<bool> {
+	static const pyeValueType valueType = pyeValueType::pyeBool;
+
+	static pyeValueType getValueType(const bool& value) {
+		return value ? pyeValueType::pyeBool : pyeValueType::pyeZero;
+	}
+
+	static void write(std::vector<unsigned char>& /*buffer*/, const bool& /*value*/) {}
+
+	static bool read(const std::vector<unsigned char>& /*buffer*/, unsigned __int64 /*offset*/, pyeValueType storedType) {
+		return storedType == pyeValueType::pyeBool;
+	}
+};
+
+/// <summary>
+/// Traits of strings: written as pyeStringUTF8L, read from pyeStringUTF8S and pyeStringUTF8L.
+/// </summary>
+template<> struct PyeValueTypeTraits<std::string> {
+	static const pyeValueType valueType = pyeValueType::pyeStringUTF8L;
+
+	static pyeValueType getValueType(const std::string& /*value*/) {
+		return pyeValueType::pyeStringUTF8L;
+	}
+
+	static void write(std::vector<unsigned char>& buffer, const std::string& value) {
+		unsigned __int32 stringLength = (unsigned __int32)value.length();
+		WriteToVector(buffer, stringLength, buffer.size());
+		buffer.insert(buffer.end(), value.begin(), value.end());
+	}
+
+	static std::string read(const std::vector<unsigned char>& buffer, unsigned __int64 offset, pyeValueType storedType) {
+		unsigned __int32 stringLength;
+		if (storedType == pyeValueType::pyeStringUTF8S) {
+			unsigned __int8 stringLengthS;
+			ReadFromVector(stringLengthS, buffer, offset);
+			stringLength = stringLengthS;
+			offset += sizeof(stringLengthS);
+		}
+		else {
+			ReadFromVector(stringLength, buffer, offset);
+			offset += sizeof(stringLength);
+		}
+		return std::string(buffer.begin() + offset, buffer.begin() + offset + stringLength);
+	}
+};
+
+/// <summary>
+/// Checks if a stored pye value type can be read as C++ type M.
+/// </summary>
+template<class M>
+bool pyeIsReadableAs(pyeValueType storedType) {
+	return storedType == PyeValueTypeTraits<M>::valueType;
+}
+
+template<>
+inline bool pyeIsReadableAs<bool>(pyeValueType storedType) {
+	return storedType == pyeValueType::pyeBool || storedType == pyeValueType::pyeZero;
+}
+
+template<>
+inline bool pyeIsReadableAs<std::string>(pyeValueType storedType) {
+	return storedType == pyeValueType::pyeStringUTF8S || storedType == pyeValueType::pyeStringUTF8L;
+}
 
 /// <summary>
 /// Holds the pointer to the byte buffer and the operations for the 
@@ -290,6 +714,49 @@ public:
 	/// <returns>Count of pyeKVS objects</returns>
 	virtual unsigned __int32 getCount() = 0;
 
+	/// <summary>
+	/// Puts a value of any C++ type with a PyeValueTypeTraits specialization to the pyeKVS data.
+	/// The pye value type and the encoding are resolved at compile time,
+	/// for fundamental types the value is written by one fixed-size memcpy.
+	/// </summary>
+	/// <typeparam name="V">C++ type of the value</typeparam>
+	/// <param name="value">value</param>
+	/// <param name="key">key name</param>
+	/// <returns>this</returns>
+	template<class V>
+	PyeBase& put(const V& value, std::string key = std::string()) {
+		writeKeyToBuffer(*getBuffer(), key);
+		if (!key.empty()) {
+			unsigned __int8 dataType = PyeValueTypeTraits<V>::getValueType(value);
+			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
+		}
+		PyeValueTypeTraits<V>::write(*getBuffer(), value);
+
+		updateObjectHeader();
+		updateHeaderSize();
+
+		return *this;
+	}
+
+	/// <summary>
+	/// Gets a value of any C++ type with a PyeValueTypeTraits specialization from the pyeKVS byte stream.
+	/// The value is read with the stored pye value type (bool from pyeBool and pyeZero,
+	/// std::string from pyeStringUTF8S and pyeStringUTF8L).
+	/// </summary>
+	/// <typeparam name="V">C++ type of the value</typeparam>
+	/// <param name="key">key name</param>
+	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
+	/// <returns>value; V() if the stored pye value type is not readable as V</returns>
+	template<class V>
+	V get(T key, unsigned __int16 mapRowItem = 0) {
+		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
+		pyeValueType storedType = getValueTypeItem(key, mapRowItem, offset);
+		if (!pyeIsReadableAs<V>(storedType)) {
+			return V();
+		}
+		return PyeValueTypeTraits<V>::read(*getBuffer(), offset, storedType);
+	}
+
 	/// <summary>
 	/// Put a 'Zero value' to the pyeKVS data. 
 	/// In this special case, only the key and the pyeKVS data type pyeZero will be added to the pykeKVS byte stream without any value.
@@ -335,17 +802,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putInt8(__int8 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeInt8;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -355,17 +812,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putInt16(__int16 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeInt16;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -375,17 +822,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putInt32(__int32 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeInt32;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -395,17 +832,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putInt64(__int64 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeInt64;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -414,21 +841,8 @@ public:
 	/// <param name="value">int128 value</param>
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
-	PyeBase& putInt128(int128 value, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeInt128;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-
-		for (int i = 0; i < value.length(); i++) {
-			WriteToVector(*getBuffer(), value[i], (*getBuffer()).size());
-		}
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+	PyeBase& putInt128(const int128& value, std::string key = std::string()) {
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -438,17 +852,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putUInt8(unsigned __int8 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeUInt8;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -458,17 +862,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putUInt16(unsigned __int16 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeUInt16;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -478,18 +872,8 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putUInt32(unsigned __int32 value = 0, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeUInt32;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
-	}
+		return put(value, key);
+	}
 
 	/// <summary>
 	/// Puts an unsigned Int64 value to the pyeKVS data.
@@ -498,17 +882,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putUInt64(unsigned __int64 value, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeUInt64;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -517,21 +891,8 @@ public:
 	/// <param name="value">unsigned int128 value</param>
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
-	PyeBase& putUInt128(uInt128 value, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeUInt128;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-
-		for (int i = 0; i < value.length(); i++) {
-			WriteToVector(*getBuffer(), value[i], (*getBuffer()).size());
-		}
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+	PyeBase& putUInt128(const uInt128& value, std::string key = std::string()) {
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -541,17 +902,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putFloat(float value, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeFloat32;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -560,21 +911,8 @@ public:
 	/// <param name="value">128bit float value</param>
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
-	PyeBase& putFloat128(float128 value, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeFloat128;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-
-		for (int i = 0; i < value.length(); i++) {
-			WriteToVector(*getBuffer(), value[i], (*getBuffer()).size());
-		}
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+	PyeBase& putFloat128(const float128& value, std::string key = std::string()) {
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -584,17 +922,7 @@ public:
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
 	PyeBase& putDouble( double value, std::string key = std::string()) {
-		writeKeyToBuffer(*getBuffer(), key);
-		if (!key.empty()) {
-			unsigned __int8 dataType = pyeValueType::pyeFloat64;
-			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
-		}
-		WriteToVector(*getBuffer(), value, (*getBuffer()).size());
-
-		updateObjectHeader();
-		updateHeaderSize();
-
-		return *this;
+		return put(value, key);
 	}
 
 	/// <summary>
@@ -655,19 +983,17 @@ public:
 	/// <param name="memory">byte stream</param>
 	/// <param name="key">key name</param>
 	/// <returns>this</returns>
-	PyeBase& putMemory(std::vector<unsigned char> memory = "", std::string key = NULL) {
+	PyeBase& putMemory(const std::vector<unsigned char>& memory, std::string key = std::string()) {
 		writeKeyToBuffer(*getBuffer(), key);
 		if (!key.empty()) {
 			unsigned __int8 dataType = pyeValueType::pyeMemory;
 			WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
 		}
 
-		unsigned __int32 memory = longString.length();
-		WriteToVector(*getBuffer(), memory, (*getBuffer()).size());
+		unsigned __int32 memorySize = (unsigned __int32)memory.size();
+		WriteToVector(*getBuffer(), memorySize, (*getBuffer()).size());
 
-		for (int i = 0; i < memory.length(); i++) {
-			WriteToVector(*getBuffer(), memory[i], (*getBuffer()).size());
-		}
+		(*getBuffer()).insert((*getBuffer()).end(), memory.begin(), memory.end());
 
 		updateObjectHeader();
 		updateHeaderSize();
@@ -718,10 +1044,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>int8 value</returns>
 	__int8 getInt8(T key, unsigned __int16 mapRowItem = 0) {
-		__int8 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<__int8>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -731,10 +1054,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>int16 value</returns>
 	__int16 getInt16(T key, unsigned __int16 mapRowItem = 0) {
-		__int16 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<__int16>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -744,10 +1064,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>int32 value</returns>
 	__int32 getInt32(T key, unsigned __int16 mapRowItem = 0) {
-		__int32 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<__int32>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -757,10 +1074,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>int64 value</returns>
 	__int64 getInt64(T key, unsigned __int16 mapRowItem = 0) {
-		__int64 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<__int64>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -770,9 +1084,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>int128 value</returns>
 	int128 getInt128(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		int128 result((*getBuffer()).begin() + offset, (*getBuffer()).begin() + offset + 16);
-		return result;
+		return get<int128>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -782,10 +1094,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>unsigned int8 value</returns>
 	unsigned __int8 getUInt8(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int8 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<unsigned __int8>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -795,10 +1104,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>unsigned int16 value</returns>
 	unsigned __int16 getUInt16(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int16 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<unsigned __int16>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -808,10 +1114,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>unsigned int32 value</returns>
 	unsigned __int32 getUInt32(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int32 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<unsigned __int32>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -821,10 +1124,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>unsigned int64 value</returns>
 	unsigned __int64 getUInt64(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int64 result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<unsigned __int64>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -834,12 +1134,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>unsigned int128 value</returns>
 	uInt128 getUInt128(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-
-		uInt128 result((*getBuffer()).begin() + offset, (*getBuffer()).begin() + offset + 16);
-//		result.shrink_to_fit();
-
-		return result;
+		return get<uInt128>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -849,10 +1144,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>float value</returns>
 	float getFloat(T key, unsigned __int16 mapRowItem = 0) {
-		float result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<float>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -862,12 +1154,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>float 128-bit value</returns>
 	float128 getFloat128(T key, unsigned __int16 mapRowItem = 0) {
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-
-		float128 result((*getBuffer()).begin() + offset, (*getBuffer()).begin() + offset + 16);
-//		result.shrink_to_fit();
-
-		return result;
+		return get<float128>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -877,10 +1164,7 @@ public:
 	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
 	/// <returns>double value</returns>
 	double getDouble(T key, unsigned __int16 mapRowItem = 0) {
-		double result;
-		unsigned __int64 offset = getOffsetItem(key, mapRowItem);
-		ReadFromVector(result, *getBuffer(), offset);
-		return result;
+		return get<double>(key, mapRowItem);
 	}
 
 	/// <summary>
@@ -958,6 +1242,15 @@ private:
 	/// <returns></returns>
 	virtual unsigned __int64 getOffsetItem(T key, unsigned __int16 mapRowItem) = 0;
 
+	/// <summary>
+	/// Gets the stored pye value type of a item in a pyeList, pyeArray or pyeArrayMap.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <param name="mapRowItem">row count, only needed in case of pyeArrayMap</param>
+	/// <param name="offsetItem">offset of the item, see getOffsetItem</param>
+	/// <returns>pye value type</returns>
+	virtual pyeValueType getValueTypeItem(T key, unsigned __int16 mapRowItem, unsigned __int64 offsetItem) = 0;
+
 	/// <summary>
 	/// Updates the header of the pyeKVS object.
 	/// </summary>
@@ -1238,8 +1531,134 @@ private:
 		
 		return offset;
 	}
+
+	virtual pyeValueType getValueTypeItem(unsigned __int32 /*idx*/, unsigned __int16 /*mapRowItem*/, unsigned __int64 /*offsetItem*/) {
+		return getArrayDataType();
+	}
 };
 
+/// <summary>
+/// Generates a hex string of the bytes of a value, e.g. of a 128-bit value or a pyeMemory.
+/// </summary>
+/// <typeparam name="B">type with begin() and end() of bytes</typeparam>
+/// <param name="bytes">bytes</param>
+/// <returns>string</returns>
+template<class B>
+std::string pyeBytesToHex(const B& bytes) {
+	std::stringstream ss;
+	for (auto byte = bytes.begin(); byte != bytes.end(); ++byte)
+		ss << std::hex << (int)*byte;
+
+	return ss.str();
+}
+
+/// <summary>
+/// Generates a JSON-formatted string of a pyeArrayMap or a pyeColumnMap, one array per row.
+/// </summary>
+/// <typeparam name="M">PyeArrayMap or PyeColumnMap</typeparam>
+/// <param name="map">pyeArrayMap or pyeColumnMap</param>
+/// <returns>string</returns>
+template<class M>
+std::string pyeMapToStringJSON(M& map) {
+	std::vector<pyeValueType> mapStruct = map.getMapStruct();
+
+	unsigned __int32 count = map.getCount();
+
+	std::string data = "[";
+
+	for (unsigned __int32 i = 0; i < count; i++) {
+
+		data.append("[");
+
+		for (unsigned __int16 j = 0; j < mapStruct.size(); j++) {
+
+			std::string value = "unknown value type";
+
+			switch (mapStruct[j]) {
+			case pyeValueType::pyeZero:
+				value = "pyeZero";
+				break;
+			case pyeValueType::pyeBool:
+				value = "pyeBool";
+				break;
+			case pyeValueType::pyeInt8:
+				value = std::to_string(map.getInt8(i, j));
+				break;
+			case pyeValueType::pyeUInt8:
+				value = std::to_string(map.getUInt8(i, j));
+				break;
+			case pyeValueType::pyeInt16:
+				value = std::to_string(map.getInt16(i, j));
+				break;
+			case pyeValueType::pyeUInt16:
+				value = std::to_string(map.getUInt16(i, j));
+				break;
+			case pyeValueType::pyeInt32:
+				value = std::to_string(map.getInt32(i, j));
+				break;
+			case pyeValueType::pyeUInt32:
+				value = std::to_string(map.getUInt32(i, j));
+				break;
+			case pyeValueType::pyeFloat32:
+				value = std::to_string(map.getFloat(i, j));
+				break;
+			case pyeValueType::pyeInt64:
+				value = std::to_string(map.getInt64(i, j));
+				break;
+			case pyeValueType::pyeUInt64:
+				value = std::to_string(map.getUInt64(i, j));
+				break;
+			case pyeValueType::pyeFloat64:
+				value = std::to_string(map.getDouble(i, j));
+				break;
+			case pyeValueType::pyeInt128:
+				value = pyeBytesToHex(map.getInt128(i, j));
+				break;
+			case pyeValueType::pyeUInt128:
+				value = pyeBytesToHex(map.getUInt128(i, j));
+				break;
+			case pyeValueType::pyeFloat128:
+				value = pyeBytesToHex(map.getFloat128(i, j));
+				break;
+			case pyeValueType::pyeStringUTF8S:
+				value = map.getStringS(i, j);
+				break;
+			case pyeValueType::pyeStringUTF8L:
+				value = map.getStringL(i, j);
+				break;
+			case pyeValueType::pyeMemory:
+				value = pyeBytesToHex(map.getMemory(i, j));
+				break;
+			default:
+				// lists, arrays and maps are no items of a map
+				break;
+			}
+
+			data.append("\"");
+			data.append(value);
+			data.append("\",");
+		}
+
+		if (data.back() == ',') {
+			std::replace(data.end() - 1, data.end(), ',', ']');
+			data.append(",");
+		}
+		else {
+			data.append("]");
+		}
+	}
+
+	if (data.back() == ',') {
+		std::replace(data.end() - 1, data.end(), ',', ']');
+		data.append(",");
+	}
+	else {
+		data.append("]");
+	}
+
+	return data;
+}
+
 /*
 * PyeArrayMap
 * Name		type				size in byte	usage
@@ -1278,6 +1697,11 @@ class PyeArrayMap : public PyeBase<unsigned __int32> {
 	/// </summary>
 	unsigned __int64 _cntItemsAll = 0;
 
+	/// <summary>
+	/// Optional table of the offsets of the rows, see getRowOffsets
+	/// </summary>
+	std::shared_ptr<const std::vector<unsigned __int64>> _rowOffsets;
+
 public:
 	/// <summary>
 	/// Contructor for a pyeArraymap
@@ -1324,6 +1748,66 @@ public:
 		return mapStruct;
 	}
 
+	/// <summary>
+	/// Puts several complete items (rows) to the pyeArrayMap.
+	/// The row data must contain the values of every row in the order of the mapStruct without pye value types.
+	/// The data is appended in one step and the headers are updated once.
+	/// </summary>
+	/// <param name="rowData">encoded values of the rows</param>
+	/// <param name="countRows">count of rows in the data</param>
+	/// <returns>this</returns>
+	PyeArrayMap& putRows(const std::vector<unsigned char>& rowData, unsigned __int32 countRows) {
+		(*getBuffer()).insert((*getBuffer()).end(), rowData.begin(), rowData.end());
+		_cntItemsAll += (unsigned __int64)countRows * getMapLength();
+
+		updateObjectHeader();
+		updateHeaderSize();
+
+		return *this;
+	}
+
+	/// <summary>
+	/// Gets the offset of the first item (row) in the byte stream.
+	/// </summary>
+	/// <returns>offset</returns>
+	unsigned __int64 getOffsetFirstItem() {
+		return getOffsetValue() + 11 /*array map header*/ + getMapLength();
+	}
+
+	/// <summary>
+	/// Gets the offsets of all rows in the byte stream with one scan of the items.
+	/// With strings or memory in the mapStruct the rows have different sizes,
+	/// so the offset of a row is found by a scan of all rows before it.
+	/// </summary>
+	/// <returns>offset of every row</returns>
+	std::vector<unsigned __int64> getRowOffsets() {
+		std::vector<pyeValueType> mapStruct = getMapStruct();
+		std::vector<unsigned __int64> rowOffsets;
+		if (mapStruct.empty()) {
+			return rowOffsets;
+		}
+
+		unsigned __int32 countRows = getCount();
+		rowOffsets.reserve(countRows);
+
+		unsigned __int64 offset = getOffsetFirstItem();
+		for (unsigned __int32 row = 0; row < countRows; row++) {
+			rowOffsets.push_back(offset);
+			offset = skipItems(mapStruct, offset, mapStruct.size());
+		}
+
+		return rowOffsets;
+	}
+
+	/// <summary>
+	/// Sets a table of the offsets of the rows (see getRowOffsets), so an item is found without a scan of the rows before it.
+	/// The table can be shared by several pyeArrayMap objects of the same byte stream.
+	/// </summary>
+	/// <param name="rowOffsets">offsets of the rows; nullptr: the rows are scanned</param>
+	void setRowOffsets(std::shared_ptr<const std::vector<unsigned __int64>> rowOffsets) {
+		_rowOffsets = rowOffsets;
+	}
+
 	/// <summary>
 	/// Gets the size (amount of bytes) of the pyeArraymap object
 	/// </summary>
@@ -1369,122 +1853,7 @@ public:
 	/// </summary>
 	/// <returns>string</returns>
 	std::string toStringJSON() {
-		std::vector<pyeValueType> mapStruct = getMapStruct();
-
-		unsigned __int32 count = getCount();
-
-		std::string data = "[";
-
-		for (unsigned __int32 i = 0; i < count; i++) {
-
-			data.append("[");
-
-			for (unsigned __int32 j = 0; j < mapStruct.size(); j++) {
-
-				pyeValueType itemValueType = mapStruct[j];
-
-				std::string value = "unknown value type";
-
-				switch (itemValueType) {
-				case pyeValueType::pyeZero:
-					value = "pyeZero";
-					break;
-				case pyeValueType::pyeBool:
-					value = "pyeBool";
-					break;
-				case pyeValueType::pyeInt8:
-					value = std::to_string(getInt8(i, j));
-					break;
-				case pyeValueType::pyeUInt8:
-					value = std::to_string(getUInt8(i, j));
-					break;
-				case pyeValueType::pyeInt16:
-					value = std::to_string(getInt16(i, j));
-					break;
-				case pyeValueType::pyeUInt16:
-					value = std::to_string(getUInt16(i, j));
-					break;
-				case pyeValueType::pyeInt32:
-					value = std::to_string(getInt32(i, j));
-					break;
-				case pyeValueType::pyeUInt32:
-					value = std::to_string(getUInt32(i, j));
-					break;
-				case pyeValueType::pyeFloat32:
-					value = std::to_string(getFloat(i, j));
-					break;
-				case pyeValueType::pyeInt64:
-					value = std::to_string(getInt64(i, j));
-					break;
-				case pyeValueType::pyeUInt64:
-					value = std::to_string(getUInt64(i, j));
-					break;
-				case pyeValueType::pyeFloat64:
-					value = std::to_string(getDouble(i, j));
-					break;
-				case pyeValueType::pyeInt128: {
-					int128 memInt128 = getInt128(i, j);
-					std::stringstream ss;
-					for (int k = 0; k < memInt128.size(); ++k)
-						ss << std::hex << (int)memInt128[k];
-
-					value = ss.str();
-				}
-				case pyeValueType::pyeUInt128: {
-					uInt128 memUInt128 = getUInt128(i, j);
-					std::stringstream ss;
-					for (int k = 0; k < memUInt128.size(); ++k)
-						ss << std::hex << (int)memUInt128[k];
-
-					value = ss.str();
-				}
-				case pyeValueType::pyeFloat128: {
-					float128 memFloat128 = getFloat128(i, j);
-					std::stringstream ss;
-					for (int k = 0; k < memFloat128.size(); ++k)
-						ss << std::hex << (int)memFloat128[k];
-
-					value = ss.str();
-				}
-				case pyeValueType::pyeStringUTF8S:
-					value = getStringS(i, j);
-					break;
-				case pyeValueType::pyeStringUTF8L:
-					value = getStringL(i, j);
-					break;
-				case pyeValueType::pyeMemory: {
-					std::vector<unsigned char> mem = getMemory(i, j);
-					std::stringstream ss;
-					for (int k = 0; k < mem.size(); ++k)
-						ss << std::hex << (int)mem[k];
-
-					value = ss.str();
-				}
-				}
-
-				data.append("\"");
-				data.append(value);
-				data.append("\",");
-			}
-
-			if (data.back() == ',') {
-				std::replace(data.end() - 1, data.end(), ',', ']');
-				data.append(",");
-			}
-			else {
-				data.append("]");
-			}
-		}
-
-		if (data.back() == ',') {
-			std::replace(data.end() - 1, data.end(), ',', ']');
-			data.append(",");
-		}
-		else {
-			data.append("]");
-		}
-
-		return data;
+		return pyeMapToStringJSON(*this);
 	}
 
 private:
@@ -1498,12 +1867,31 @@ private:
 
 	// StreamPos[array value data start] + Index * SizeOf(MapStruct)
 	virtual unsigned __int64 getOffsetItem(unsigned __int32 row, unsigned __int16 mapRowItem) {
-		unsigned __int64 offset = getOffsetValue() + 11/*array map header*/ + getMapLength();
 		std::vector<pyeValueType> mapStruct = getMapStruct();
+
+		// with the table of the rows only the items of the row before the item are skipped
+		if (_rowOffsets && row < _rowOffsets->size()) {
+			return skipItems(mapStruct, (*_rowOffsets)[row], mapRowItem);
+		}
+
 		unsigned __int64 itemIdx = (unsigned __int64)mapRowItem + (unsigned __int64)row * (unsigned __int64)mapStruct.size();
+		return skipItems(mapStruct, getOffsetFirstItem(), itemIdx);
+	}
+
+	virtual pyeValueType getValueTypeItem(unsigned __int32 /*row*/, unsigned __int16 mapRowItem, unsigned __int64 /*offsetItem*/) {
+		return (pyeValueType)(*getBuffer())[getOffsetValue() + 3 /*pyeValueType(1 byte) + information length of map (2 byte)*/ + mapRowItem];
+	}
 
-		for (unsigned __int64 i = 0; i < itemIdx; i++) {
-			pyeValueType typeItem = getMapStruct()[i % mapStruct.size()];
+	/// <summary>
+	/// Skips items, which start with the first column of the mapStruct.
+	/// </summary>
+	/// <param name="mapStruct">pye value types of the columns</param>
+	/// <param name="offset">offset of the first item</param>
+	/// <param name="count">count of items to skip</param>
+	/// <returns>offset behind the skipped items</returns>
+	unsigned __int64 skipItems(const std::vector<pyeValueType>& mapStruct, unsigned __int64 offset, unsigned __int64 count) {
+		for (unsigned __int64 i = 0; i < count; i++) {
+			pyeValueType typeItem = mapStruct[i % mapStruct.size()];
 
 			switch (typeItem) {
 				case pyeValueType::pyeStringUTF8S:
@@ -1531,6 +1919,274 @@ private:
 	}
 };
 
+/*
+* PyeColumnMap
+* Name			type				size in byte	usage
+* pyeColumnMap	pyeValueType		1				Value=22
+* MapLength		UInt16				2				length of the MapStruct; Number of columns; Max. 65535
+* MapStruct		pyeValueType		MapLength		pyeValueType and their order of the columns; 1 Byte per value type
+* Size			UInt32				4				size of value data of complete pyeColumnMap; start after Count
+* Count			UInt32				4				count of items (rows)
+* Offset0		UInt32				4				offset of the values of column 0; start after the offsets
+* Offset1		UInt32				4				offset of the values of column 1
+* Offset		UInt32				4				one offset per column
+* Column0		pyeValues							values of column 0 of all rows
+* Column1		pyeValues							values of column 1 of all rows
+* Column		pyeValues							values of the column of all rows
+
+* StreamPos[column value data start] + Row * SizeOf(column data type)
+*/
+
+/// <summary>
+/// The pyeColumnMap is a container to store items as a map like the pyeArrayMap,
+/// but the values are stored column by column (column-major). 
+/// The values of one column are contiguous in the byte stream, the header holds the offset of every column.
+/// A scan of one column reads only the bytes of the column, columns with fixed-size values are plain C arrays.
+/// The pyeColumnMap can contain the same value types like the pyeArrayMap.
+/// Values are added in rows; the values of a single put are moved to the end of their column,
+/// so the pyeColumnMap must be the last object in the byte stream while it is filled.
+/// </summary>
+class PyeColumnMap : public PyeBase<unsigned __int32> {
+	/// <summary>
+	/// Parental list of this ColumnMap
+	/// </summary>
+	PyeList* _pLastList = nullptr;
+
+	/// <summary>
+	/// Offset of this ColumnMap in the pyeKVS byte stream
+	/// </summary>
+	unsigned __int64 _offsetObject = 0;
+
+	/// <summary>
+	/// Count of items in this ColumnMap
+	/// </summary>
+	unsigned __int64 _cntItemsAll = 0;
+
+	/// <summary>
+	/// Offset of the value of the last single put at the end of the byte stream; 0 if there is no value to move
+	/// </summary>
+	unsigned __int64 _offsetPutValue = 0;
+
+public:
+	/// <summary>
+	/// Contructor for a pyeColumnMap
+	/// </summary>
+	/// <param name="buffer">pointer to the pyeKVS byte stream</param>
+	/// <param name="offsetObjectStart">offset in the byte stream</param>
+	PyeColumnMap(std::vector<unsigned char>* buffer, unsigned __int64 offsetObjectStart) {
+		setOffsetObject(offsetObjectStart);
+		setBuffer(buffer);
+	}
+
+	/// <summary>
+	/// Contructor for a pyeColumnMap
+	/// </summary>
+	/// <param name="pLastList">parent pyeList of this pyeColumnMap</param>
+	/// <param name="mapStruct">pye value type structure of the items in the pyeColumnMap. One value type represents one column</param>
+	/// <param name="offsetObjectStart">offset in the byte stream</param>
+	PyeColumnMap(PyeList* pLastList, std::vector<pyeValueType> mapStruct, unsigned __int64 offsetObjectStart);
+
+	/// <summary>
+	/// Gets the length of the mapStruct (pye value types), Number of columns; Max. 65535
+	/// </summary>
+	/// <returns>length</returns>
+	unsigned __int16 getMapLength() {
+		unsigned __int16 mapLength;
+		ReadFromVector(mapLength, *getBuffer(), getOffsetValue() + 1 /*pyeValueType(1 byte)*/);
+
+		return mapLength;
+	}
+
+	/// <summary>
+	/// Gets the structure of the pyeColumnMap, 1 Byte per value type
+	/// </summary>
+	/// <returns>vector of pye value types</returns>
+	std::vector<pyeValueType> getMapStruct() {
+		unsigned __int64 offset = getOffsetValue() + 3 /*pyeValueType(1 byte) + information length of map (2 byte)*/;
+		return std::vector<pyeValueType>((pyeValueType*)&(*getBuffer())[offset], (pyeValueType*)&(*getBuffer())[offset] + getMapLength());
+	}
+
+	/// <summary>
+	/// Gets the pye value type of a column
+	/// </summary>
+	/// <param name="column">index of the column</param>
+	/// <returns>pye value type</returns>
+	pyeValueType getColumnType(unsigned __int16 column) {
+		return (pyeValueType)(*getBuffer())[getOffsetValue() + 3 /*pyeValueType(1 byte) + information length of map (2 byte)*/ + column];
+	}
+
+	/// <summary>
+	/// Gets the size (amount of bytes) of the pyeColumnMap object
+	/// </summary>
+	/// <returns>size</returns>
+	virtual unsigned __int32 getSize() {
+		unsigned __int32 mapSize;
+		ReadFromVector(mapSize, *getBuffer(), getOffsetValue() + 3 /*pyeValueType(1 byte) + information length of map (2 byte)*/ + getMapLength());
+
+		return mapSize;
+	}
+
+	/// <summary>
+	/// Gets the count of items (rows) of the pyeColumnMap
+	/// </summary>
+	/// <returns>count</returns>
+	virtual unsigned __int32 getCount() {
+		unsigned __int32 mapCount;
+		ReadFromVector(mapCount, *getBuffer(), getOffsetValue() + 7 /*pyeValueType(1 byte) + information length of map (2 byte) + mapSize(4 byte)*/ + getMapLength());
+
+		return mapCount;
+	}
+
+	/// <summary>
+	/// Gets the offset of the first value of a column in the byte stream.
+	/// </summary>
+	/// <param name="column">index of the column</param>
+	/// <returns>offset</returns>
+	unsigned __int64 getOffsetColumn(unsigned __int16 column) {
+		unsigned __int16 mapLength = getMapLength();
+		unsigned __int64 offsetColumnTable = getOffsetValue() + 11 /*column map header*/ + mapLength;
+
+		unsigned __int32 offsetColumn;
+		ReadFromVector(offsetColumn, *getBuffer(), offsetColumnTable + 4 * (unsigned __int64)column);
+
+		return offsetColumnTable + 4 * (unsigned __int64)mapLength + offsetColumn;
+	}
+
+	/// <summary>
+	/// Gets the size (amount of bytes) of the values of a column.
+	/// </summary>
+	/// <param name="column">index of the column</param>
+	/// <returns>size</returns>
+	unsigned __int64 getSizeColumn(unsigned __int16 column) {
+		unsigned __int64 offsetColumnEnd;
+		if (column + 1 < getMapLength()) {
+			offsetColumnEnd = getOffsetColumn(column + 1);
+		}
+		else {
+			offsetColumnEnd = getOffsetValue() + 11 /*column map header*/ + getMapLength() + getSize();
+		}
+
+		return offsetColumnEnd - getOffsetColumn(column);
+	}
+
+	/// <summary>
+	/// Reads all values of a column in one sequential pass.
+	/// A column with fixed-size values of the C++ type is copied by one memcpy.
+	/// </summary>
+	/// <typeparam name="V">C++ type of the values</typeparam>
+	/// <param name="column">index of the column</param>
+	/// <param name="values">vector for the values; the values are appended</param>
+	/// <returns>false, if the column does not exist or has another pye value type</returns>
+	template<class V>
+	bool getColumn(unsigned __int16 column, std::vector<V>& values) {
+		if (column >= getMapLength()) {
+			return false;
+		}
+
+		pyeValueType columnType = getColumnType(column);
+		if (!pyeIsReadableAs<V>(columnType)) {
+			return false;
+		}
+
+		const std::vector<unsigned char>& buffer = *getBuffer();
+		unsigned __int32 count = getCount();
+		unsigned __int64 offset = getOffsetColumn(column);
+		size_t idxFirst = values.size();
+		values.resize(idxFirst + count);
+
+		if (std::is_arithmetic<V>::value && getSizeOfFundamentalValueType(columnType) == sizeof(V)) {
+			if (count > 0) {
+				memcpy((void*)&values[idxFirst], &buffer[offset], (size_t)count * sizeof(V));
+			}
+		}
+		else {
+			for (unsigned __int32 i = 0; i < count; i++) {
+				values[idxFirst + i] = PyeValueTypeTraits<V>::read(buffer, offset, columnType);
+				offset += getSizeOfValueData(buffer, offset, columnType);
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Puts several complete items (rows) to the pyeColumnMap.
+	/// The data of every column must contain the values of all rows without pye value types.
+	/// The values are appended to their columns in one step and the headers are updated once.
+	/// </summary>
+	/// <param name="columnData">encoded values, one vector per column</param>
+	/// <param name="countRows">count of rows in the data</param>
+	/// <returns>this</returns>
+	PyeColumnMap& putColumns(const std::vector<std::vector<unsigned char>>& columnData, unsigned __int32 countRows);
+
+	/// <summary>
+	/// Puts several complete items (rows) to the pyeColumnMap.
+	/// The row data contains the values of every row in the order of the mapStruct without pye value types,
+	/// like the row data of a pyeArrayMap. The values are split into the columns in one pass.
+	/// </summary>
+	/// <param name="rowData">encoded values of the rows</param>
+	/// <param name="countRows">count of rows in the data</param>
+	/// <returns>this</returns>
+	PyeColumnMap& putRows(const std::vector<unsigned char>& rowData, unsigned __int32 countRows);
+
+	/// <summary>
+	/// Sets the offset of the pyeColumnMap object in the byte stream. 
+	/// </summary>
+	/// <param name="offset">offset</param>
+	virtual void setOffsetObject(unsigned __int64 offset) {
+		_offsetObject = offset;
+	};
+
+	/// <summary>
+	/// Gets the offset of the pyeColumnMap in the byte stream.
+	/// </summary>
+	/// <returns>offset</returns>
+	virtual unsigned __int64 getOffsetObject() {
+		return _offsetObject;
+	};
+
+	/// <summary>
+	/// Generates JSON-formatted string of the pyeColumnMap, row by row like the pyeArrayMap.
+	/// </summary>
+	/// <returns>string</returns>
+	std::string toStringJSON() {
+		return pyeMapToStringJSON(*this);
+	}
+
+private:
+
+	virtual void updateObjectHeader();
+
+	virtual unsigned __int64 writeKeyToBuffer(std::vector<unsigned char>& buffer, std::string /*key*/) {
+		_cntItemsAll++;
+		_offsetPutValue = buffer.size();
+		return buffer.size();
+	}
+
+	// StreamPos[column value data start] + Row * SizeOf(column data type)
+	virtual unsigned __int64 getOffsetItem(unsigned __int32 row, unsigned __int16 column) {
+		unsigned __int64 offset = getOffsetColumn(column);
+		pyeValueType typeColumn = getColumnType(column);
+
+		switch (typeColumn) {
+			case pyeValueType::pyeStringUTF8S:
+			case pyeValueType::pyeStringUTF8L:
+			case pyeValueType::pyeMemory:
+				for (unsigned __int32 i = 0; i < row; i++) {
+					offset += getSizeOfValueData(*getBuffer(), offset, typeColumn);
+				}
+				return offset;
+
+			default:
+				return offset + (unsigned __int64)row * getSizeOfFundamentalValueType(typeColumn);
+		}
+	}
+
+	virtual pyeValueType getValueTypeItem(unsigned __int32 /*row*/, unsigned __int16 column, unsigned __int64 /*offsetItem*/) {
+		return getColumnType(column);
+	}
+};
+
 /*
 * Name		type			size in byte	usage
 * pyeList	pyeValueType	1				Value=1
@@ -1553,9 +2209,10 @@ private:
 class PyeList : public PyeBase<std::string> {
 	friend PyeArray;
 	friend PyeArrayMap;
+	friend PyeColumnMap;
 
 	unsigned __int64 _offsetObject = 0;
-	std::map<std::string, unsigned __int64> _mapItemIdx;
+	PyeItemIdx _mapItemIdx;
 	PyeList* _pLastList = nullptr;
 
 public:
@@ -1569,6 +2226,28 @@ public:
 		decode();
 	}
 
+	/// <summary>
+	/// Puts a value of any C++ type with a PyeValueTypeTraits specialization to the pyeList.
+	/// Same as PyeBase::put, but the key and the headers are written by the non-virtual
+	/// methods of the list, so the whole put is inlined.
+	/// </summary>
+	/// <typeparam name="V">C++ type of the value</typeparam>
+	/// <param name="value">value</param>
+	/// <param name="key">key name</param>
+	/// <returns>this</returns>
+	template<class V>
+	PyeList& put(const V& value, const std::string& key) {
+		writeKey(key);
+		unsigned __int8 dataType = PyeValueTypeTraits<V>::getValueType(value);
+		WriteToVector(*getBuffer(), dataType, (*getBuffer()).size());
+		PyeValueTypeTraits<V>::write(*getBuffer(), value);
+
+		updateListHeader();
+		updateHeaderSize();
+
+		return *this;
+	}
+
 	PyeArray putArray(std::string key, pyeValueType arrayType) {
 
 		unsigned __int64 offsetObjectStart = writeKeyToBuffer(*getBuffer(), key);
@@ -1587,6 +2266,15 @@ public:
 		return newArrayMap;
 	}
 
+	PyeColumnMap putColumnMap(std::string key, std::vector<pyeValueType> mapStruct) {
+
+		unsigned __int64 offsetObjectStart = writeKeyToBuffer(*getBuffer(), key);
+
+		PyeColumnMap newColumnMap(this, mapStruct, offsetObjectStart);
+
+		return newColumnMap;
+	}
+
 	// create new empty list on buffer
 	PyeList putList(std::string key) {
 
@@ -1617,20 +2305,134 @@ public:
 
 
 	PyeArrayMap getArrayMap(std::string key) {
-		PyeArrayMap result(getBuffer(), _mapItemIdx[key]);
+		PyeArrayMap result(getBuffer(), getOffsetObjectItem(key));
+		return result;
+	}
+
+	PyeColumnMap getColumnMap(std::string key) {
+		PyeColumnMap result(getBuffer(), getOffsetObjectItem(key));
 		return result;
 	}
 
 	PyeArray getArray(std::string key) {
-		PyeArray result(getBuffer(), _mapItemIdx[key]);
+		PyeArray result(getBuffer(), getOffsetObjectItem(key));
 		return result;
 	}
 
 	PyeList getList(std::string key) {
-		PyeList result(getBuffer(), _mapItemIdx[key]);
+		PyeList result(getBuffer(), getOffsetObjectItem(key));
 		return result;
 	}
 
+	/// <summary>
+	/// Puts an already encoded pyeKVS object (key and value) to the pyeKVS data.
+	/// The bytes are copied from the source stream without decoding the value.
+	/// </summary>
+	/// <param name="source">byte stream of the encoded object</param>
+	/// <param name="offsetObject">offset of the object in the source byte stream</param>
+	/// <returns>this</returns>
+	PyeList& putRaw(std::vector<unsigned char>& source, unsigned __int64 offsetObject) {
+		appendRawObject(source, offsetObject);
+
+		updateObjectHeader();
+		updateHeaderSize();
+
+		return *this;
+	}
+
+	/// <summary>
+	/// Puts several already encoded pyeKVS objects to the pyeKVS data.
+	/// The headers of the list and the document are updated only once after all objects are copied.
+	/// </summary>
+	/// <param name="source">byte stream of the encoded objects</param>
+	/// <param name="offsetObjects">offsets of the objects in the source byte stream</param>
+	/// <returns>this</returns>
+	PyeList& putRaw(std::vector<unsigned char>& source, const std::vector<unsigned __int64>& offsetObjects) {
+		for (unsigned __int64 offsetObject : offsetObjects) {
+			appendRawObject(source, offsetObject);
+		}
+
+		updateObjectHeader();
+		updateHeaderSize();
+
+		return *this;
+	}
+
+	/// <summary>
+	/// Puts the encoded value of a pyeKVS object of another byte stream with a new key to the pyeKVS data.
+	/// </summary>
+	/// <param name="key">new key name</param>
+	/// <param name="source">byte stream of the encoded object</param>
+	/// <param name="offsetObject">offset of the object in the source byte stream</param>
+	/// <returns>this</returns>
+	PyeList& putRawValue(std::string key, std::vector<unsigned char>& source, unsigned __int64 offsetObject) {
+		return putRawValues(std::vector<std::string>(1, key), std::vector<std::vector<unsigned char>*>(1, &source), std::vector<unsigned __int64>(1, offsetObject));
+	}
+
+	/// <summary>
+	/// Puts the encoded values of pyeKVS objects of other byte streams with new keys to the pyeKVS data.
+	/// E.g. the root lists of separately built pyeDocuments are spliced as sub-lists into this list.
+	/// The buffer is enlarged once and the headers are updated once after all values are copied.
+	/// </summary>
+	/// <param name="keys">new key names</param>
+	/// <param name="sources">byte streams of the encoded objects</param>
+	/// <param name="offsetObjects">offsets of the objects in the source byte streams</param>
+	/// <returns>this</returns>
+	PyeList& putRawValues(const std::vector<std::string>& keys, const std::vector<std::vector<unsigned char>*>& sources, const std::vector<unsigned __int64>& offsetObjects) {
+		std::vector<unsigned __int64> offsetValues(keys.size());
+		unsigned __int64 sizeTotal = (*getBuffer()).size();
+
+		for (size_t i = 0; i < keys.size(); i++) {
+			offsetValues[i] = offsetObjects[i] + 1 /*information key size*/ + (*sources[i])[offsetObjects[i]];
+			sizeTotal += 1 /*information key size*/ + keys[i].length();
+			sizeTotal += getOffsetValueEnd(*sources[i], offsetValues[i]) - offsetValues[i];
+		}
+		(*getBuffer()).reserve(sizeTotal);
+
+		for (size_t i = 0; i < keys.size(); i++) {
+			std::vector<unsigned char>& source = *sources[i];
+			unsigned __int64 offsetValueEnd = getOffsetValueEnd(source, offsetValues[i]);
+
+			writeKeyToBuffer(*getBuffer(), keys[i]);
+			if (&source == getBuffer()) {
+				// copy first, a range of the buffer cannot be inserted into the buffer itself
+				std::vector<unsigned char> value(source.begin() + offsetValues[i], source.begin() + offsetValueEnd);
+				(*getBuffer()).insert((*getBuffer()).end(), value.begin(), value.end());
+			}
+			else {
+				(*getBuffer()).insert((*getBuffer()).end(), source.begin() + offsetValues[i], source.begin() + offsetValueEnd);
+			}
+		}
+
+		updateObjectHeader();
+		updateHeaderSize();
+
+		return *this;
+	}
+
+	/// <summary>
+	/// Gets the index of the items of the list.
+	/// </summary>
+	/// <returns>map of key and offset of the pyeKVS object in the byte stream</returns>
+	const PyeItemIdx& getItemIdx() {
+		return _mapItemIdx;
+	}
+
+	/// <summary>
+	/// Gets the offsets of the items of the list in the order of the byte stream.
+	/// </summary>
+	/// <returns>offsets of the pyeKVS objects</returns>
+	std::vector<unsigned __int64> getItemOffsets() {
+		std::vector<unsigned __int64> offsets;
+		offsets.reserve(_mapItemIdx.size());
+		for (const auto& item : _mapItemIdx) {
+			offsets.push_back(item.second);
+		}
+		std::sort(offsets.begin(), offsets.end());
+
+		return offsets;
+	}
+
 	virtual void decode() {
 		_mapItemIdx.clear();
 
@@ -1652,79 +2454,7 @@ public:
 
 			idx += keySize;
 
-			unsigned __int8 valueType;
-			ReadFromVector(valueType, buffer, idx);
-
-			idx += sizeof(valueType);
-
-			switch (valueType) {
-			case 20u:	// pyeArray; UInt32 Size + UInt32 Count
-				idx += 1; /*info data type of array items*/
-			case 1u:	// pyeList; UInt32 Size + UInt32 Count
-				unsigned __int32 listLength;
-				ReadFromVector(listLength, buffer, idx);
-				idx += sizeof(listLength);
-				idx += 4; /*info count of items*/
-				idx += listLength;
-				break;
-			case 2u:	// pyeZero; -
-				// code block
-				break;
-			case 3u:	// pyeBool; -
-				// code block
-				break;
-			case 4u:	// pyeInt8; 1 Byte
-			case 5u:	// pyeUInt8; 1 Byte
-				idx += 1;
-				break;
-			case 6u:	// pyeInt16; 2 Byte
-			case 7u:	// pyeUInt16; 2 Byte 
-				idx += 2;
-				break;
-			case 8u:	// pyeInt32; 4 Byte
-			case 9u:	// pyeUInt32; 4 Byte 
-			case 14u:	// pyeFloat32; 4 Byte 
-				idx += 4;
-				break;
-			case 10u:	// pyeInt64; 8 Byte
-			case 11u:	// pyeUInt64; 8 Byte
-			case 15u:	// pyeFloat64; 8 Byte
-				idx += 8;
-				break;
-			case 12u:	// pyeInt128; 16 Byte
-			case 13u:	// pyeUInt128; 16 Byte
-			case 16u:	// pyeFloat128; 16 Byte
-				idx += 16;
-				break;
-			case 17u:	// pyeStringUTF8S; UInt8 as char count
-				unsigned __int8 stringLength;
-				ReadFromVector(stringLength, buffer, idx);
-				idx += sizeof(stringLength);
-				idx += stringLength;
-				break;
-			case 18u:	// pyeStringUTF8L; UInt32 as char count
-			case 19u:	// pyeMemory; UInt32 size of mem
-				unsigned __int32 dataLength;
-				ReadFromVector(dataLength, buffer, idx);
-				idx += sizeof(dataLength);
-				idx += dataLength;
-				break;
-			case 21u:	// pyeArrayMap; UInt16 map length + map + UInt32 Size + UInt32 Count
-				unsigned __int16 mapLength;
-				ReadFromVector(mapLength, buffer, idx);
-				idx += sizeof(mapLength);
-				idx += mapLength;
-
-				unsigned __int32 mapSize;
-				ReadFromVector(mapSize, buffer, idx);
-				idx += sizeof(mapSize);
-				idx += 4; /*count of items*/
-				idx += mapSize;
-				break;
-			default: // type: 0
-				// code block
-				break;
-			}
+			idx = getOffsetValueEnd(buffer, idx);
 		}
 	}
 
@@ -1751,11 +2481,11 @@ public:
 	};
 
 	std::string toStringJSON(std::string separator = "", std::string levelIndicator = "") {
-		return toString(separator, levelIndicator, "");
+		return toString(separator, levelIndicator, "") + separator;
 	}
 
 	std::string toStringSimple(std::string separator = "", std::string levelIndicator = "") {
-		return toString(separator, levelIndicator, "", false);
+		return toString(separator, levelIndicator, "", false) + separator;
 	}
 
 private:
@@ -1769,6 +2499,13 @@ private:
 	}
 
 	virtual void updateObjectHeader() {
+		updateListHeader();
+	}
+
+	/// <summary>
+	/// Updates the size and the count of the list and of its parent lists.
+	/// </summary>
+	void updateListHeader() {
 		unsigned __int64 offsetFirstItem = getOffsetValue();
 		offsetFirstItem += 1; /*information about pye value type (uint8)*/
 		offsetFirstItem += 4; /*information about list size (uint32)*/
@@ -1781,7 +2518,7 @@ private:
 		WriteToVector(*getBuffer(), listCount, getOffsetValue() + 1 /*information about pye value type*/ + 4 /*information about list size*/);
 
 		if (_pLastList) {
-			_pLastList->updateObjectHeader();
+			_pLastList->updateListHeader();
 		}
 	};
 
@@ -1789,23 +2526,67 @@ private:
 	/// @param buffer 
 	/// @param key 
 	/// @return 
-	virtual unsigned __int64 writeKeyToBuffer(std::vector<unsigned char>& buffer, std::string key) {
+	virtual unsigned __int64 writeKeyToBuffer(std::vector<unsigned char>& /*buffer*/, std::string key) {
+		return writeKey(key);
+	}
+
+	/// <summary>
+	/// Writes the key to the end of the byte stream and adds it to the index of the list.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <returns>offset of the new pyeKVS object</returns>
+	unsigned __int64 writeKey(const std::string& key) {
 		unsigned __int64 offsetObjectStart = (*getBuffer()).size();
 
 		unsigned __int8 keyLength = key.length();
 		WriteToVector(*getBuffer(), keyLength, offsetObjectStart);
+		(*getBuffer()).insert((*getBuffer()).end(), key.begin(), key.end());
+
+		_mapItemIdx.insert(std::pair<std::string, unsigned __int64>(key, offsetObjectStart));
+
+		return offsetObjectStart;
+	}
+
+	/// <summary>
+	/// Copies a encoded pyeKVS object to the end of the byte stream and adds its key to the index.
+	/// </summary>
+	/// <param name="source">byte stream of the encoded object</param>
+	/// <param name="offsetObject">offset of the object in the source byte stream</param>
+	void appendRawObject(std::vector<unsigned char>& source, unsigned __int64 offsetObject) {
+		unsigned __int64 offsetObjectEnd = getOffsetObjectEnd(source, offsetObject);
+		unsigned __int64 offsetObjectStart = (*getBuffer()).size();
+
+		unsigned __int8 keySize;
+		ReadFromVector(keySize, source, offsetObject);
+		std::string key(&source[offsetObject + 1], &source[offsetObject + 1] + keySize);
 
-		for (int i = 0; i < key.length(); i++) {
-			WriteToVector(*getBuffer(), key[i], (*getBuffer()).size());
+		if (&source == getBuffer()) {
+			// copy first, the insert may reallocate the source
+			std::vector<unsigned char> object(source.begin() + offsetObject, source.begin() + offsetObjectEnd);
+			(*getBuffer()).insert((*getBuffer()).end(), object.begin(), object.end());
+		}
+		else {
+			(*getBuffer()).insert((*getBuffer()).end(), source.begin() + offsetObject, source.begin() + offsetObjectEnd);
 		}
 
 		_mapItemIdx.insert(std::pair<std::string, unsigned __int64>(key, offsetObjectStart));
+	}
 
-		return offsetObjectStart;
+	/// <summary>
+	/// Gets the offset of the pyeKVS object of a key without changing the index.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <returns>offset of the object; 0 if the key does not exist</returns>
+	unsigned __int64 getOffsetObjectItem(const std::string& key) const {
+		auto item = _mapItemIdx.find(key);
+		if (item == _mapItemIdx.end()) {
+			return 0;
+		}
+		return item->second;
 	}
 
 	virtual unsigned __int64 getOffsetItem(std::string key, unsigned __int16 mapRowItem) {
-		unsigned __int64 idx = _mapItemIdx[key];
+		unsigned __int64 idx = getOffsetObjectItem(key);
 
 		unsigned __int8 keySize;
 		ReadFromVector(keySize, *getBuffer(), idx);
@@ -1817,14 +2598,30 @@ private:
 		return idx;
 	}
 
+	virtual pyeValueType getValueTypeItem(std::string /*key*/, unsigned __int16 /*mapRowItem*/, unsigned __int64 offsetItem) {
+		return (pyeValueType)(*getBuffer())[offsetItem - 1 /*pye value type in front of the value data*/];
+	}
+
 	std::string toString(std::string separator, std::string levelIndicator, std::string levelIndicatorAccu, bool json = true) {
 		std::string data = "{";
 		data.append(separator);
 
-		int cntItem = 0;
+		// reserved objects are no data of the list; the comma follows every item but the last one
+		size_t countItems = 0;
+		for (const auto& item : _mapItemIdx) {
+			if (!pyeIsReservedKey(item.first)) {
+				countItems++;
+			}
+		}
+
+		size_t cntItem = 0;
 		for (const auto& item : _mapItemIdx) {
+			if (pyeIsReservedKey(item.first)) {
+				continue;
+			}
 
 			unsigned __int64 offsetItemValueType = getOffsetItem(item.first, NULL);
+
 			offsetItemValueType--; // offset value type
 
 			unsigned __int8 itemValueType;
@@ -1832,7 +2629,14 @@ private:
 
 			data.append(levelIndicatorAccu + levelIndicator);
 			data.append("\"");
-			data.append(item.first);
+			if (pyeIsInternedKey(item.first)) {
+				// without the key dictionary only the id is known
+				data.append("#");
+				data.append(std::to_string(pyeInternedKeyId(item.first)));
+			}
+			else {
+				data.append(item.first);
+			}
 			data.append("\"");
 			
 			if (!json) {
@@ -1860,6 +2664,17 @@ private:
 					data.append(" Count ");
 					data.append(std::to_string(getArrayMap(item.first).getCount()));
 				}
+				else if (itemValueType == 22) {	// pyeColumnMap
+					std::vector<pyeValueType> types = getColumnMap(item.first).getMapStruct();
+					data.append(" of ");
+					for (pyeValueType type:types) {
+						data.append(pyeKVSValueTypeName[type]);
+						data.append(",");
+					}
+					data = data.substr(0, data.size() - 1);
+					data.append(" Count ");
+					data.append(std::to_string(getColumnMap(item.first).getCount()));
+				}
 
 				data.append(")");
 			}
@@ -1873,11 +2688,12 @@ private:
 			}
 			else if (itemValueType == 20) {	// pyeArray
 				data.append(getArray(item.first).toStringJSON());
-				data.append(separator);
 			}
 			else if (itemValueType == 21) {	// pyeArrayMap
 				data.append(getArrayMap(item.first).toStringJSON());
-				data.append(separator);
+			}
+			else if (itemValueType == 22) {	// pyeColumnMap
+				data.append(getColumnMap(item.first).toStringJSON());
 			}
 			else {
 				switch (itemValueType) {
@@ -1964,14 +2780,14 @@ private:
 				data.append("\"");
 				data.append(value);
 				data.append("\"");
+			}
 
-				if (cntItem < _mapItemIdx.size() - 1) {
-					data.append(",");
-				}
-
-				data.append(separator);
+			if (cntItem < countItems - 1) {
+				data.append(",");
 			}
 
+			data.append(separator);
+
 			cntItem++;
 		}
 
@@ -1979,12 +2795,212 @@ private:
 
 		data.append("}");
 
-		data.append(separator);
-
 		return data;
 	}
 };
 
+/// <summary>
+/// Pool of reusable byte buffers for pyeDocuments.
+/// A released buffer is cleared but keeps its capacity (high-water mark), so a document of the next message
+/// is encoded without a new allocation of its buffer. The buffers are handed out as shared pointers,
+/// which return the buffer to the pool, when the last owner (e.g. the pyeDocument) is destroyed.
+/// The control blocks of the shared pointers are reused as well, so acquire and release of a pooled buffer
+/// allocate nothing on the heap.
+/// The pool is thread safe; buffers can be released after the destruction of the pool.
+/// </summary>
+class PyeBufferPool {
+	/// <summary> State of the pool, shared with the deleters of the handed out buffers </summary>
+	struct State {
+		std::mutex mutex;
+
+		/// <summary> Free buffers </summary>
+		std::vector<std::vector<unsigned char>*> buffers;
+
+		/// <summary> Free control blocks of the shared pointers </summary>
+		std::vector<void*> blocks;
+
+		/// <summary> Size of a control block; 0, until the first control block is freed </summary>
+		size_t sizeBlock = 0;
+
+		/// <summary> Capacity of a new buffer </summary>
+		size_t capacityInitial;
+
+		/// <summary> Maximal count of free buffers </summary>
+		size_t countMax;
+
+		/// <summary> Maximal capacity of a retained buffer; 0: no limit </summary>
+		size_t capacityMax;
+
+		~State() {
+			for (std::vector<unsigned char>* buffer : buffers) {
+				delete buffer;
+			}
+			for (void* block : blocks) {
+				::operator delete(block);
+			}
+		}
+	};
+
+	/// <summary>
+	/// Allocator of the control blocks of the shared pointers, which takes the free control blocks of the pool.
+	/// </summary>
+	template<class T>
+	struct BlockAllocator {
+		typedef T value_type;
+
+		std::shared_ptr<State> state;
+
+		BlockAllocator(const std::shared_ptr<State>& state) : state(state) {}
+
+		template<class U>
+		BlockAllocator(const BlockAllocator<U>& other) : state(other.state) {}
+
+		T* allocate(size_t count) {
+			size_t size = count * sizeof(T);
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (size == state->sizeBlock && !state->blocks.empty()) {
+					void* block = state->blocks.back();
+					state->blocks.pop_back();
+					return static_cast<T*>(block);
+				}
+			}
+			return static_cast<T*>(::operator new(size));
+		}
+
+		void deallocate(T* block, size_t count) {
+			size_t size = count * sizeof(T);
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (state->sizeBlock == 0) {
+					state->sizeBlock = size;
+				}
+				if (size == state->sizeBlock && state->blocks.size() < state->countMax) {
+					state->blocks.push_back(block);
+					return;
+				}
+			}
+			::operator delete(block);
+		}
+
+		template<class U>
+		bool operator==(const BlockAllocator<U>& other) const {
+			return state == other.state;
+		}
+
+		template<class U>
+		bool operator!=(const BlockAllocator<U>& other) const {
+			return state != other.state;
+		}
+	};
+
+	/// <summary>
+	/// Deleter of the shared pointers, which returns the buffer to the pool.
+	/// </summary>
+	struct Releaser {
+		std::shared_ptr<State> state;
+
+		void operator()(std::vector<unsigned char>* buffer) const {
+			release(*state, buffer);
+		}
+	};
+
+	std::shared_ptr<State> _state = std::make_shared<State>();
+
+public:
+	/// <summary>
+	/// Constructor of a buffer pool
+	/// </summary>
+	/// <param name="capacityInitial">capacity of a new buffer</param>
+	/// <param name="countMax">maximal count of free buffers; further released buffers are deleted</param>
+	/// <param name="capacityMax">maximal capacity of a retained buffer, larger buffers are deleted; 0: no limit</param>
+	PyeBufferPool(size_t capacityInitial = DATASIZE, size_t countMax = 64, size_t capacityMax = 0) {
+		_state->capacityInitial = capacityInitial;
+		_state->countMax = countMax;
+		_state->capacityMax = capacityMax;
+
+		// the free lists never grow on a release
+		_state->buffers.reserve(countMax);
+		_state->blocks.reserve(countMax);
+	}
+
+	PyeBufferPool(const PyeBufferPool&) = delete;
+	PyeBufferPool& operator=(const PyeBufferPool&) = delete;
+
+	/// <summary>
+	/// Gets an empty buffer of the pool or a new buffer, if the pool is empty.
+	/// </summary>
+	/// <returns>buffer, which returns to the pool with its last owner</returns>
+	std::shared_ptr<std::vector<unsigned char>> acquire() {
+		std::vector<unsigned char>* buffer = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(_state->mutex);
+			if (!_state->buffers.empty()) {
+				buffer = _state->buffers.back();
+				_state->buffers.pop_back();
+			}
+		}
+
+		if (buffer == nullptr) {
+			buffer = new std::vector<unsigned char>();
+			buffer->reserve(_state->capacityInitial);
+		}
+
+		return std::shared_ptr<std::vector<unsigned char>>(buffer, Releaser{ _state }, BlockAllocator<unsigned char>(_state));
+	}
+
+	/// <summary>
+	/// Allocates buffers in advance.
+	/// </summary>
+	/// <param name="count">count of free buffers after the call</param>
+	void reserve(size_t count) {
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		while (_state->buffers.size() < count) {
+			std::vector<unsigned char>* buffer = new std::vector<unsigned char>();
+			buffer->reserve(_state->capacityInitial);
+			_state->buffers.push_back(buffer);
+		}
+	}
+
+	/// <summary>
+	/// Gets the count of free buffers.
+	/// </summary>
+	size_t getCountFree() {
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		return _state->buffers.size();
+	}
+
+	/// <summary>
+	/// Deletes all free buffers.
+	/// </summary>
+	void clear() {
+		std::lock_guard<std::mutex> lock(_state->mutex);
+		for (std::vector<unsigned char>* buffer : _state->buffers) {
+			delete buffer;
+		}
+		_state->buffers.clear();
+		for (void* block : _state->blocks) {
+			::operator delete(block);
+		}
+		_state->blocks.clear();
+	}
+
+private:
+	static void release(State& state, std::vector<unsigned char>* buffer) {
+		buffer->clear();
+
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+			if (state.buffers.size() < state.countMax && (state.capacityMax == 0 || buffer->capacity() <= state.capacityMax)) {
+				state.buffers.push_back(buffer);
+				return;
+			}
+		}
+
+		delete buffer;
+	}
+};
+
 /*
 Name			type	size in byte	usage
 StreamPrefix	UInt32	4				constant: $53455950 (PYES)
@@ -2024,13 +3040,55 @@ class PyeDocument {
 	/// Name of the pyeKVS root list. default: "" </summary>
 	std::string		 _rootName = "";			// __uint8 
 
+	/// <summary>
+	/// Buffer owned by the document (and its copies); empty, if the buffer is owned by the caller. </summary>
+	std::shared_ptr<std::vector<unsigned char>> _ownedBuffer;
+
 public:
 	PyeDocument() {
+		_ownedBuffer = std::make_shared<std::vector<unsigned char>>();
+		create(_ownedBuffer.get());
+	}
+
+	/// <summary> Constructor of a new and empty pyeDocument with a buffer of a buffer pool.
+	/// The buffer returns to the pool, when the document and all its copies are destroyed.
+	/// </summary>
+	/// <param name="pool">buffer pool</param>
+	PyeDocument(PyeBufferPool& pool) {
+		_ownedBuffer = pool.acquire();
+		create(_ownedBuffer.get());
+	}
+
+	/// <summary> Constructor of a pyeDocument object with a pyeKVS buffer.
+	/// </summary>
+	/// <param name="pbuffer">pyeKVS buffer</param>
+	/// <param name="create">true: the buffer is cleared and a new empty pyeDoc is written to it; false: the buffer is decoded</param>
+	PyeDocument(std::vector<unsigned char>* pbuffer, bool create) {
+		if (create) {
+			this->create(pbuffer);
+		}
+		else {
+			_rootList.setOffsetObject(_offsetHeader);
+			_rootList.setBuffer(pbuffer);
+			_rootList.decode();
+		}
+	}
+
+	/// <summary> Writes a new and empty pyeDoc to a buffer and uses this buffer.
+	/// Existing data of the buffer are cleared, the capacity of the buffer is kept.
+	/// </summary>
+	/// <param name="pbuffer">pyeKVS buffer</param>
+	void create(std::vector<unsigned char>* pbuffer) {
+		if (pbuffer != _ownedBuffer.get()) {
+			_ownedBuffer.reset();
+		}
 
-		std::vector<unsigned char> *_pbuffer = new std::vector<unsigned char>(0);
-		_rootList.setBuffer(_pbuffer);
+		pbuffer->clear();
+		_rootList = PyeList();
+		_rootList.setBuffer(pbuffer);
 
 		// write header data to buffer
+
 		setHeaderPrefix(_headerPrefix);
 		setHeaderVersionH(_headerVersionH);
 		setHeaderVersionL(_headerVersionL);
@@ -2054,6 +3112,13 @@ public:
 		_rootList.setOffsetObject(_offsetHeader);
 	}
 
+	/// <summary> Clears the document to a new and empty pyeDoc.
+	/// The capacity of the buffer is kept, so the document is reused without a new allocation.
+	/// </summary>
+	void reset() {
+		create(getBuffer());
+	}
+
 	/// <summary> Constructor of a pyeDocument object with a filename to a pyeKVS file.
 	/// </summary>
 	/// <param name="filename">Filename of the pyeKVS file</param>
@@ -2062,13 +3127,13 @@ public:
 		// reads data from file in input file stream
 		std::ifstream input(filename, std::ios::binary);
 
-		// copies all data into buffer, static to not lost data after loosing scope
-		std::vector<unsigned char> *buffer = new std::vector<unsigned char>(std::istreambuf_iterator<char>(input), {});
+		// copies all data into buffer, owned by the document and its copies
+		_ownedBuffer = std::make_shared<std::vector<unsigned char>>(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
 
 		// set offset to begin of root list object
 		_rootList.setOffsetObject(_offsetHeader);
 		// set buffer
-		_rootList.setBuffer(buffer);
+		_rootList.setBuffer(_ownedBuffer.get());
 		// decode buffer
 		_rootList.decode();
 	}
@@ -2089,6 +3154,10 @@ public:
 	/// </summary>
 	/// <param name="pbuffer">pyeKVS buffer</param>
 	void setBuffer(std::vector<unsigned char>* pbuffer) {
+		if (pbuffer != _ownedBuffer.get()) {
+			_ownedBuffer.reset();
+		}
+
 		// reset offset to root list object
 		_rootList.setOffsetObject(_offsetHeader);
 		// set new buffer
@@ -2213,6 +3282,8 @@ public:
 	pyeMemory		19							UInt32 size of mem										mem data bytes	see notes
 	pyeArray		20							UInt32 Size + UInt32 Count								values			see notes
 	pyeArrayMap		21							UInt16 map length + map + UInt32 Size + UInt32 Count	values			see notes
+	pyeColumnMap	22							UInt16 map length + map + UInt32 Size + UInt32 Count	UInt32 offset per column + values per column	see notes
+
 	*/
 /*
 	// https://stackoverflow.com/questions/39838716/is-there-a-way-to-call-multiple-functions-on-the-same-object-with-one-line
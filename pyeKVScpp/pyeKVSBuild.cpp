@@ -0,0 +1,49 @@
+//#include "pch.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "pyeKVSBuild.h"
+
+
+void PyeParallelBuilder::build(PyeList& listParent, unsigned int threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	if (threads > _builds.size()) {
+		threads = (unsigned int)_builds.size();
+	}
+
+	_buffers.resize(_builds.size());
+
+	// every thread takes the next not built sub-list
+	std::atomic<size_t> nextBuild(0);
+
+	auto worker = [&]() {
+		for (size_t i = nextBuild++; i < _builds.size(); i = nextBuild++) {
+			PyeDocument document(&_buffers[i], true);
+			_builds[i](document.getRoot());
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < threads; i++) {
+		pool.push_back(std::thread(worker));
+	}
+	worker();
+
+	for (std::thread& thread : pool) {
+		thread.join();
+	}
+
+	// splice the root lists of all documents into the parent list
+	std::vector<std::vector<unsigned char>*> sources;
+	std::vector<unsigned __int64> offsetObjects;
+	for (size_t i = 0; i < _builds.size(); i++) {
+		sources.push_back(&_buffers[i]);
+		offsetObjects.push_back(16 /*document header*/);
+	}
+
+	listParent.putRawValues(_keys, sources, offsetObjects);
+}
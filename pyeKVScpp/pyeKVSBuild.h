@@ -0,0 +1,62 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : parallel encoding of independent sub-lists of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/// <summary>
+/// Builds independent sub-lists of a pyeList in parallel.
+/// Every sub-list is encoded by its build function as the root list of an own pyeDocument
+/// with an own buffer. After all threads are finished, the sub-lists are spliced into the
+/// parent list in the order of adding, with one enlargement of the buffer and one header update.
+/// </summary>
+class PyeParallelBuilder {
+	/// <summary> Keys of the sub-lists </summary>
+	std::vector<std::string> _keys;
+
+	/// <summary> Build functions of the sub-lists </summary>
+	std::vector<std::function<void(PyeList& list)>> _builds;
+
+	/// <summary> Buffers of the sub-lists; kept to reuse their capacity in the next build </summary>
+	std::vector<std::vector<unsigned char>> _buffers;
+
+public:
+	/// <summary>
+	/// Adds a sub-list.
+	/// </summary>
+	/// <param name="key">key name of the sub-list in the parent list</param>
+	/// <param name="build">function which puts the items to the (empty) sub-list; runs in a worker thread</param>
+	void add(const std::string& key, std::function<void(PyeList& list)> build) {
+		_keys.push_back(key);
+		_builds.push_back(build);
+	}
+
+	/// <summary>
+	/// Removes all added sub-lists.
+	/// </summary>
+	void clear() {
+		_keys.clear();
+		_builds.clear();
+	}
+
+	/// <summary>
+	/// Runs the build functions of all sub-lists in parallel and puts the sub-lists to the parent list.
+	/// </summary>
+	/// <param name="listParent">parent list</param>
+	/// <param name="threads">count of threads; 0 uses the count of cores</param>
+	void build(PyeList& listParent, unsigned int threads = 0);
+};
@@ -0,0 +1,117 @@
+//#include "pch.h"
+
+#include <string>
+#include <vector>
+
+#include "pyeKVSCache.h"
+
+
+std::shared_ptr<const PyeContainerCache::ItemIdx> PyeContainerCache::getItemIdx(const PyeByteSpan& data, unsigned __int64 offsetList) {
+	Key key = { data.data(), offsetList };
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		const Entry* entry = find(key);
+		if (entry != nullptr && entry->itemIdx) {
+			return entry->itemIdx;
+		}
+	}
+
+	// the list is decoded without the lock, so other containers are read in the meantime
+	std::shared_ptr<ItemIdx> itemIdx = std::make_shared<ItemIdx>();
+	PyeDocumentIndex::decodeList(data, offsetList, *itemIdx);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	insert(Entry{ key, itemIdx, nullptr, getSizeItemIdx(*itemIdx) });
+	return itemIdx;
+}
+
+std::shared_ptr<const PyeContainerCache::RowOffsets> PyeContainerCache::getRowOffsets(const PyeByteSpan& data, unsigned __int64 offsetArrayMap) {
+	Key key = { data.data(), offsetArrayMap };
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		const Entry* entry = find(key);
+		if (entry != nullptr && entry->rowOffsets) {
+			return entry->rowOffsets;
+		}
+	}
+
+	std::shared_ptr<RowOffsets> rowOffsets = std::make_shared<RowOffsets>();
+	scanRows(data, offsetArrayMap, *rowOffsets);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	insert(Entry{ key, nullptr, rowOffsets, sizeof(RowOffsets) + rowOffsets->capacity() * sizeof(unsigned __int64) });
+	return rowOffsets;
+}
+
+void PyeContainerCache::clear() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_lru.clear();
+	_entries.clear();
+	_size = 0;
+}
+
+const PyeContainerCache::Entry* PyeContainerCache::find(const Key& key) {
+	auto item = _entries.find(key);
+	if (item == _entries.end()) {
+		_countMisses++;
+		return nullptr;
+	}
+
+	_countHits++;
+	_lru.splice(_lru.begin(), _lru, item->second);
+	return &*item->second;
+}
+
+void PyeContainerCache::insert(const Entry& entry) {
+	// another thread inserted the container in the meantime
+	if (_entries.count(entry.key) || entry.size > _sizeMax) {
+		return;
+	}
+
+	_lru.push_front(entry);
+	_entries[entry.key] = _lru.begin();
+	_size += entry.size;
+
+	while (_size > _sizeMax) {
+		const Entry& last = _lru.back();
+		_size -= last.size;
+		_entries.erase(last.key);
+		_lru.pop_back();
+		_countEvictions++;
+	}
+}
+
+size_t PyeContainerCache::getSizeItemIdx(const ItemIdx& itemIdx) {
+	// node of the map: pointers of the tree, key and offset; long keys are stored on the heap
+	size_t size = sizeof(ItemIdx);
+	for (const auto& item : itemIdx) {
+		size += 4 * sizeof(void*) + sizeof(ItemIdx::value_type);
+		if (item.first.size() >= sizeof(std::string)) {
+			size += item.first.size() + 1;
+		}
+	}
+	return size;
+}
+
+void PyeContainerCache::scanRows(const PyeByteSpan& data, unsigned __int64 offsetArrayMap, RowOffsets& rowOffsets) {
+	// value of the pyeArrayMap: pye value type, length of the mapStruct (UInt16), mapStruct, size (UInt32), count of rows (UInt32), items
+	unsigned __int64 offsetValue = offsetArrayMap + 1 /*information size of key*/ + data[offsetArrayMap];
+	unsigned __int16 mapLength;
+	ReadFromVector(mapLength, data, offsetValue + 1);
+	if (mapLength == 0) {
+		return;
+	}
+
+	unsigned __int32 countRows;
+	ReadFromVector(countRows, data, offsetValue + 7 + mapLength);
+	rowOffsets.reserve(countRows);
+
+	const unsigned char* mapStruct = &data[offsetValue + 3];
+	unsigned __int64 offset = offsetValue + 11 /*array map header*/ + mapLength;
+	for (unsigned __int32 row = 0; row < countRows && offset < data.size(); row++) {
+		rowOffsets.push_back(offset);
+		for (unsigned __int16 column = 0; column < mapLength; column++) {
+			offset += getSizeOfValueData(data, offset, (pyeValueType)mapStruct[column]);
+		}
+	}
+}
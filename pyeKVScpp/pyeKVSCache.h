@@ -0,0 +1,156 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : LRU cache of decoded containers of pyeKVS byte streams
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
+#include "pyeKVS.h"
+#include "pyeKVSIndex.h"
+
+#pragma once
+
+/// <summary>
+/// LRU cache of the decoded containers of pyeKVS byte streams, e.g. a large mapped archive with random queries.
+/// The cache holds the index of the items of pyeLists and the table of the rows of pyeArrayMaps,
+/// with the first byte of the byte stream and the offset of the container in the byte stream as key.
+/// A hot container is decoded once; the least recently used containers are removed,
+/// when the memory of the cached indexes exceeds the maximum.
+/// The cache is thread safe and is given to PyeDocumentView, which passes it to the views of all sub-lists.
+/// The byte streams must not be changed or moved while the cache is in use.
+/// </summary>
+class PyeContainerCache {
+public:
+	typedef PyeDocumentIndex::ItemIdx ItemIdx;
+	typedef std::vector<unsigned __int64> RowOffsets;
+
+	/// <summary>
+	/// Constructor of a cache
+	/// </summary>
+	/// <param name="sizeMax">maximum memory of the cached indexes in bytes</param>
+	PyeContainerCache(size_t sizeMax) : _sizeMax(sizeMax) {}
+
+	PyeContainerCache(const PyeContainerCache&) = delete;
+	PyeContainerCache& operator=(const PyeContainerCache&) = delete;
+
+	/// <summary>
+	/// Gets the index of the items of a pyeList; the list is decoded, if it is not in the cache.
+	/// </summary>
+	/// <param name="data">byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object in the byte stream</param>
+	/// <returns>index of the items</returns>
+	std::shared_ptr<const ItemIdx> getItemIdx(const PyeByteSpan& data, unsigned __int64 offsetList);
+
+	/// <summary>
+	/// Gets the table of the rows of a pyeArrayMap; the rows are scanned, if the table is not in the cache.
+	/// </summary>
+	/// <param name="data">byte stream</param>
+	/// <param name="offsetArrayMap">offset of the pyeArrayMap object in the byte stream</param>
+	/// <returns>offsets of the rows, see PyeArrayMap::getRowOffsets</returns>
+	std::shared_ptr<const RowOffsets> getRowOffsets(const PyeByteSpan& data, unsigned __int64 offsetArrayMap);
+
+	/// <summary>
+	/// Removes all containers from the cache. The counters are kept.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Gets the memory of the cached indexes in bytes (estimated).
+	/// </summary>
+	size_t getSize() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _size;
+	}
+
+	size_t getSizeMax() const {
+		return _sizeMax;
+	}
+
+	size_t getCount() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _entries.size();
+	}
+
+	unsigned __int64 getCountHits() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _countHits;
+	}
+
+	unsigned __int64 getCountMisses() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _countMisses;
+	}
+
+	unsigned __int64 getCountEvictions() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _countEvictions;
+	}
+
+private:
+	/// <summary> Key of a container: first byte of the byte stream and offset of the container </summary>
+	struct Key {
+		const unsigned char* data;
+		unsigned __int64 offset;
+
+		bool operator==(const Key& key) const {
+			return data == key.data && offset == key.offset;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			return std::hash<const unsigned char*>()(key.data) ^ std::hash<unsigned __int64>()(key.offset);
+		}
+	};
+
+	/// <summary> Cached container: index of a pyeList or table of a pyeArrayMap </summary>
+	struct Entry {
+		Key key;
+		std::shared_ptr<const ItemIdx> itemIdx;
+		std::shared_ptr<const RowOffsets> rowOffsets;
+		size_t size;
+	};
+
+	std::mutex _mutex;
+	size_t _sizeMax;
+	size_t _size = 0;
+
+	/// <summary> Entries in the order of use; the most recently used entry is the first </summary>
+	std::list<Entry> _lru;
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _entries;
+
+	unsigned __int64 _countHits = 0;
+	unsigned __int64 _countMisses = 0;
+	unsigned __int64 _countEvictions = 0;
+
+	/// <summary>
+	/// Finds an entry and moves it to the front; counts the hit or the miss.
+	/// </summary>
+	/// <returns>entry; nullptr, if the container is not in the cache</returns>
+	const Entry* find(const Key& key);
+
+	/// <summary>
+	/// Inserts an entry and removes the least recently used entries, until the size is not above the maximum.
+	/// An entry larger than the maximum is not inserted.
+	/// </summary>
+	void insert(const Entry& entry);
+
+	static size_t getSizeItemIdx(const ItemIdx& itemIdx);
+
+	/// <summary>
+	/// Scans the rows of a pyeArrayMap in a byte stream.
+	/// </summary>
+	static void scanRows(const PyeByteSpan& data, unsigned __int64 offsetArrayMap, RowOffsets& rowOffsets);
+};
@@ -0,0 +1,221 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : sorted secondary indexes on columns of pyeArrayMaps
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "pyeKVS.h"
+#include "pyeKVSScan.h"
+
+#pragma once
+
+/*
+* Usage:
+*	PyeColumnIndex<__int64> index;
+*	index.build(arrayMap, 0);						// one pass over the rows, sorted by value
+*
+*	unsigned __int32 row;
+*	index.find(4711, row);							// point lookup, O(log n)
+*	index.findRange(100, 200, rows);				// range lookup, all rows with 100 <= value <= 200
+*
+*	index.put(list, "idxId");						// persists the index as pyeArrayMap (value, row)
+*	PyeArrayMap arrayMapIdx = list.getArrayMap("idxId");
+*	index.load(arrayMapIdx);
+*/
+
+/// <summary>
+/// Secondary index on one column of a pyeArrayMap or pyeColumnMap.
+/// The index holds the values of the column with their row numbers, sorted by value
+/// (and by row for equal values) in one contiguous vector.
+/// Point and range lookups are binary searches.
+/// The index can be stored in the document as pyeArrayMap with the columns value and row.
+/// </summary>
+/// <typeparam name="V">C++ type of the values of the column</typeparam>
+template<class V>
+class PyeColumnIndex {
+	static_assert(!std::is_same<V, bool>::value, "bool has no value data in a pyeArrayMap, use unsigned __int8");
+
+public:
+	/// <summary> Entry of the index: value and row number </summary>
+	typedef std::pair<V, unsigned __int32> Entry;
+
+private:
+	/// <summary> Entries sorted by value and row </summary>
+	std::vector<Entry> _entries;
+
+	struct LessValue {
+		bool operator()(const Entry& entry, const V& value) const {
+			return entry.first < value;
+		}
+		bool operator()(const V& value, const Entry& entry) const {
+			return value < entry.first;
+		}
+	};
+
+public:
+	/// <summary>
+	/// Builds the index of a column of a pyeArrayMap.
+	/// </summary>
+	/// <param name="arrayMap">pyeArrayMap</param>
+	/// <param name="column">index of the column</param>
+	/// <returns>false, if the column does not exist or can not be read as V</returns>
+	bool build(PyeArrayMap& arrayMap, unsigned __int16 column) {
+		_entries.clear();
+
+		std::vector<pyeValueType> mapStruct = arrayMap.getMapStruct();
+		if (column >= mapStruct.size() || !pyeIsReadableAs<V>(mapStruct[column])) {
+			return false;
+		}
+
+		_entries.reserve(arrayMap.getCount());
+
+		PyeScan scan;
+		scan.scanRows(arrayMap, [&](unsigned __int32 row, const PyeScanRow& values) {
+			_entries.push_back(Entry(values.get<V>(column), row));
+		});
+
+		std::sort(_entries.begin(), _entries.end());
+		return true;
+	}
+
+	/// <summary>
+	/// Builds the index of a column of a pyeColumnMap.
+	/// </summary>
+	/// <param name="columnMap">pyeColumnMap</param>
+	/// <param name="column">index of the column</param>
+	/// <returns>false, if the column does not exist or can not be read as V</returns>
+	bool build(PyeColumnMap& columnMap, unsigned __int16 column) {
+		_entries.clear();
+
+		std::vector<V> values;
+		if (!columnMap.getColumn(column, values)) {
+			return false;
+		}
+
+		_entries.reserve(values.size());
+		for (size_t i = 0; i < values.size(); i++) {
+			_entries.push_back(Entry(std::move(values[i]), (unsigned __int32)i));
+		}
+
+		std::sort(_entries.begin(), _entries.end());
+		return true;
+	}
+
+	/// <summary>
+	/// Finds the first row with a value.
+	/// </summary>
+	/// <param name="value">value</param>
+	/// <param name="row">row number, if found</param>
+	/// <returns>true, if found</returns>
+	bool find(const V& value, unsigned __int32& row) const {
+		auto entry = std::lower_bound(_entries.begin(), _entries.end(), value, LessValue());
+		if (entry == _entries.end() || value < entry->first) {
+			return false;
+		}
+		row = entry->second;
+		return true;
+	}
+
+	/// <summary>
+	/// Finds all rows with a value.
+	/// </summary>
+	/// <param name="value">value</param>
+	/// <param name="rows">vector for the row numbers in ascending order; cleared before the lookup</param>
+	/// <returns>count of rows</returns>
+	size_t find(const V& value, std::vector<unsigned __int32>& rows) const {
+		return findRange(value, value, rows);
+	}
+
+	/// <summary>
+	/// Finds all rows with a value in a range; from &lt;= value &lt;= to.
+	/// </summary>
+	/// <param name="from">lower limit of the range</param>
+	/// <param name="to">upper limit of the range</param>
+	/// <param name="rows">vector for the row numbers in order of the values; cleared before the lookup</param>
+	/// <returns>count of rows</returns>
+	size_t findRange(const V& from, const V& to, std::vector<unsigned __int32>& rows) const {
+		rows.clear();
+
+		auto first = std::lower_bound(_entries.begin(), _entries.end(), from, LessValue());
+		auto last = std::upper_bound(first, _entries.end(), to, LessValue());
+		for (auto entry = first; entry < last; entry++) {
+			rows.push_back(entry->second);
+		}
+
+		return rows.size();
+	}
+
+	/// <summary>
+	/// Gets the count of entries (rows) in the index.
+	/// </summary>
+	/// <returns>count</returns>
+	size_t getCount() const {
+		return _entries.size();
+	}
+
+	/// <summary>
+	/// Gets the sorted entries of the index.
+	/// </summary>
+	/// <returns>entries</returns>
+	const std::vector<Entry>& getEntries() const {
+		return _entries;
+	}
+
+	/// <summary>
+	/// Puts the index as new pyeArrayMap with the columns value and row to the list.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	/// <param name="key">key name of the pyeArrayMap</param>
+	/// <returns>pyeArrayMap</returns>
+	PyeArrayMap put(PyeList& list, std::string key) const {
+		std::vector<pyeValueType> mapStruct;
+		mapStruct.push_back(PyeValueTypeTraits<V>::getValueType(V()));
+		mapStruct.push_back(pyeValueType::pyeUInt32);
+
+		std::vector<unsigned char> rowData;
+		rowData.reserve(_entries.size() * (getSizeOfFundamentalValueType(mapStruct[0]) + sizeof(unsigned __int32)));
+		for (const Entry& entry : _entries) {
+			PyeValueTypeTraits<V>::write(rowData, entry.first);
+			PyeValueTypeTraits<unsigned __int32>::write(rowData, entry.second);
+		}
+
+		PyeArrayMap arrayMap = list.putArrayMap(key, mapStruct);
+		arrayMap.putRows(rowData, (unsigned __int32)_entries.size());
+		return arrayMap;
+	}
+
+	/// <summary>
+	/// Loads an index, which was stored with put.
+	/// </summary>
+	/// <param name="arrayMap">pyeArrayMap with the columns value and row</param>
+	/// <returns>false, if the pyeArrayMap is not an index of values V</returns>
+	bool load(PyeArrayMap& arrayMap) {
+		_entries.clear();
+
+		std::vector<pyeValueType> mapStruct = arrayMap.getMapStruct();
+		if (mapStruct.size() != 2 || !pyeIsReadableAs<V>(mapStruct[0]) || mapStruct[1] != pyeValueType::pyeUInt32) {
+			return false;
+		}
+
+		_entries.reserve(arrayMap.getCount());
+
+		PyeScan scan;
+		scan.scanRows(arrayMap, [&](unsigned __int32 /*row*/, const PyeScanRow& values) {
+			_entries.push_back(Entry(values.get<V>(0), values.get<unsigned __int32>(1)));
+		});
+
+		return true;
+	}
+};
@@ -0,0 +1,283 @@
+//#include "pch.h"
+
+#include <vector>
+#include <cstring>
+
+#include "pyeKVSCompress.h"
+
+
+static const char pyeCompressMagic[4] = { 'P', 'Y', 'E', 'Z' };
+
+/*
+* Sequence of the LZ codec
+* Token		UInt8		high 4 bits count of literals, low 4 bits length of the match - 4; 15 = more bytes follow
+* Literals	bytes		(optional 255, 255, ..., rest for a count of literals >= 15) and the literals
+* Offset	UInt16		distance of the match back from the current position
+* Length	bytes		optional 255, 255, ..., rest for a length of the match >= 19
+* The last sequence has only literals.
+*/
+static const size_t pyeLZMinMatch = 4;
+static const size_t pyeLZLastLiterals = 5;
+static const unsigned int pyeLZHashBits = 14;
+
+static void pyeLZWriteLength(std::vector<unsigned char>& compressed, size_t length) {
+	while (length >= 255) {
+		compressed.push_back(255);
+		length -= 255;
+	}
+	compressed.push_back((unsigned char)length);
+}
+
+static void pyeLZWriteSequence(std::vector<unsigned char>& compressed, const unsigned char* literals, size_t countLiterals, size_t offset, size_t lengthMatch) {
+	unsigned char token = (unsigned char)((countLiterals >= 15 ? 15 : countLiterals) << 4);
+	if (lengthMatch > 0) {
+		token |= (unsigned char)(lengthMatch - pyeLZMinMatch >= 15 ? 15 : lengthMatch - pyeLZMinMatch);
+	}
+	compressed.push_back(token);
+
+	if (countLiterals >= 15) {
+		pyeLZWriteLength(compressed, countLiterals - 15);
+	}
+	compressed.insert(compressed.end(), literals, literals + countLiterals);
+
+	if (lengthMatch > 0) {
+		compressed.push_back((unsigned char)(offset & 0xFF));
+		compressed.push_back((unsigned char)(offset >> 8));
+
+		if (lengthMatch - pyeLZMinMatch >= 15) {
+			pyeLZWriteLength(compressed, lengthMatch - pyeLZMinMatch - 15);
+		}
+	}
+}
+
+void PyeCodecLZ::compress(const unsigned char* data, size_t size, std::vector<unsigned char>& compressed) const {
+	// positions + 1 of the last 4 byte sequences with the same hash; 0 is empty
+	std::vector<unsigned __int32> table((size_t)1 << pyeLZHashBits, 0);
+
+	size_t anchor = 0;
+	size_t pos = 0;
+	size_t misses = 0;
+
+	while (size > pyeLZLastLiterals + pyeLZMinMatch && pos < size - pyeLZLastLiterals - pyeLZMinMatch) {
+		unsigned __int32 sequence;
+		memcpy(&sequence, &data[pos], sizeof(sequence));
+
+		unsigned __int32 hash = (sequence * 2654435761U) >> (32 - pyeLZHashBits);
+		size_t ref = table[hash];
+		table[hash] = (unsigned __int32)(pos + 1);
+
+		if (ref > 0 && pos - (ref - 1) <= 0xFFFF && memcmp(&data[ref - 1], &data[pos], pyeLZMinMatch) == 0) {
+			ref--;
+
+			size_t lengthMatch = pyeLZMinMatch;
+			size_t lengthMax = size - pyeLZLastLiterals - pos;
+			while (lengthMatch < lengthMax && data[ref + lengthMatch] == data[pos + lengthMatch]) {
+				lengthMatch++;
+			}
+
+			pyeLZWriteSequence(compressed, &data[anchor], pos - anchor, pos - ref, lengthMatch);
+
+			pos += lengthMatch;
+			anchor = pos;
+			misses = 0;
+		}
+		else {
+			// skip faster through data without matches
+			pos += 1 + (misses++ >> 6);
+		}
+	}
+
+	pyeLZWriteSequence(compressed, &data[anchor], size - anchor, 0, 0);
+}
+
+bool PyeCodecLZ::decompress(const unsigned char* compressed, size_t sizeCompressed, unsigned char* data, size_t size) const {
+	size_t in = 0;
+	size_t out = 0;
+
+	while (in < sizeCompressed) {
+		unsigned char token = compressed[in++];
+
+		size_t countLiterals = token >> 4;
+		if (countLiterals == 15) {
+			unsigned char next;
+			do {
+				if (in >= sizeCompressed) {
+					return false;
+				}
+				next = compressed[in++];
+				countLiterals += next;
+			} while (next == 255);
+		}
+
+		if (countLiterals > sizeCompressed - in || countLiterals > size - out) {
+			return false;
+		}
+		memcpy(&data[out], &compressed[in], countLiterals);
+		in += countLiterals;
+		out += countLiterals;
+
+		// the last sequence has no match
+		if (in == sizeCompressed) {
+			break;
+		}
+
+		if (in + 2 > sizeCompressed) {
+			return false;
+		}
+		size_t offset = compressed[in] | ((size_t)compressed[in + 1] << 8);
+		in += 2;
+
+		size_t lengthMatch = (token & 0x0F);
+		if (lengthMatch == 15) {
+			unsigned char next;
+			do {
+				if (in >= sizeCompressed) {
+					return false;
+				}
+				next = compressed[in++];
+				lengthMatch += next;
+			} while (next == 255);
+		}
+		lengthMatch += pyeLZMinMatch;
+
+		if (offset == 0 || offset > out || lengthMatch > size - out) {
+			return false;
+		}
+
+		if (offset >= lengthMatch) {
+			memcpy(&data[out], &data[out - offset], lengthMatch);
+		}
+		else {
+			// overlapping match repeats the last bytes
+			for (size_t i = 0; i < lengthMatch; i++) {
+				data[out + i] = data[out - offset + i];
+			}
+		}
+		out += lengthMatch;
+	}
+
+	return out == size;
+}
+
+void PyeBlockCompression::encode(const unsigned char* data, unsigned __int64 size, std::vector<unsigned char>& stream,
+	const PyeCodec& codec, unsigned __int32 blockSize) {
+	stream.clear();
+
+	if (blockSize == 0) {
+		blockSize = defaultBlockSize;
+	}
+	unsigned __int32 countBlocks = (unsigned __int32)((size + blockSize - 1) / blockSize);
+
+	stream.insert(stream.end(), pyeCompressMagic, pyeCompressMagic + sizeof(pyeCompressMagic));
+	unsigned __int8 codecId = codec.getId();
+	WriteToVector(stream, codecId, stream.size());
+	WriteToVector(stream, blockSize, stream.size());
+	WriteToVector(stream, size, stream.size());
+	WriteToVector(stream, countBlocks, stream.size());
+
+	unsigned __int64 offsetTable = stream.size();
+	stream.resize(stream.size() + countBlocks * 8ULL);
+
+	unsigned __int64 offsetBlocks = stream.size();
+	std::vector<unsigned char> block;
+
+	for (unsigned __int32 i = 0; i < countBlocks; i++) {
+		unsigned __int64 offsetRaw = (unsigned __int64)i * blockSize;
+		size_t sizeRaw = (size_t)std::min<unsigned __int64>(blockSize, size - offsetRaw);
+
+		block.clear();
+		codec.compress(&data[offsetRaw], sizeRaw, block);
+
+		// incompressible blocks are stored raw
+		if (block.size() < sizeRaw) {
+			stream.insert(stream.end(), block.begin(), block.end());
+		}
+		else {
+			stream.insert(stream.end(), &data[offsetRaw], &data[offsetRaw] + sizeRaw);
+		}
+
+		unsigned __int64 blockEnd = stream.size() - offsetBlocks;
+		WriteToVector(stream, blockEnd, offsetTable + i * 8ULL);
+	}
+}
+
+bool PyeBlockCompression::getRawSize(const unsigned char* stream, unsigned __int64 sizeStream, unsigned __int64& size) {
+	if (sizeStream < sizeHeader || memcmp(stream, pyeCompressMagic, sizeof(pyeCompressMagic)) != 0) {
+		return false;
+	}
+	memcpy(&size, &stream[9], sizeof(size));
+	return true;
+}
+
+bool PyeBlockCompression::decodeRange(const unsigned char* stream, unsigned __int64 sizeStream, unsigned __int64 offset, unsigned __int64 size,
+	std::vector<unsigned char>& data, const PyeCodec& codec) {
+	data.clear();
+
+	unsigned __int64 sizeRawAll;
+	if (!getRawSize(stream, sizeStream, sizeRawAll) || stream[4] != codec.getId()) {
+		return false;
+	}
+
+	unsigned __int32 blockSize, countBlocks;
+	memcpy(&blockSize, &stream[5], sizeof(blockSize));
+	memcpy(&countBlocks, &stream[17], sizeof(countBlocks));
+
+	unsigned __int64 offsetBlocks = sizeHeader + countBlocks * 8ULL;
+	if (blockSize == 0 || offsetBlocks > sizeStream || offset > sizeRawAll || size > sizeRawAll - offset
+		|| (sizeRawAll + blockSize - 1) / blockSize != countBlocks) {
+		return false;
+	}
+
+	if (size == 0) {
+		return true;
+	}
+	data.resize((size_t)size);
+
+	std::vector<unsigned char> block;
+	unsigned __int32 blockFirst = (unsigned __int32)(offset / blockSize);
+	unsigned __int32 blockLast = (unsigned __int32)((offset + size - 1) / blockSize);
+
+	for (unsigned __int32 i = blockFirst; i <= blockLast; i++) {
+		unsigned __int64 blockStart = 0;
+		unsigned __int64 blockEnd;
+		if (i > 0) {
+			memcpy(&blockStart, &stream[sizeHeader + (i - 1) * 8ULL], sizeof(blockStart));
+		}
+		memcpy(&blockEnd, &stream[sizeHeader + i * 8ULL], sizeof(blockEnd));
+		if (blockStart > blockEnd || offsetBlocks + blockEnd > sizeStream) {
+			data.clear();
+			return false;
+		}
+
+		unsigned __int64 offsetRaw = (unsigned __int64)i * blockSize;
+		size_t sizeRaw = (size_t)std::min<unsigned __int64>(blockSize, sizeRawAll - offsetRaw);
+		const unsigned char* compressed = &stream[offsetBlocks + blockStart];
+		size_t sizeCompressed = (size_t)(blockEnd - blockStart);
+
+		// part of the block in the range
+		unsigned __int64 copyStart = std::max(offset, offsetRaw);
+		unsigned __int64 copyEnd = std::min(offset + size, offsetRaw + sizeRaw);
+		unsigned char* target = &data[(size_t)(copyStart - offset)];
+
+		if (sizeCompressed == sizeRaw) {
+			memcpy(target, compressed + (copyStart - offsetRaw), (size_t)(copyEnd - copyStart));
+		}
+		else if (copyStart == offsetRaw && copyEnd == offsetRaw + sizeRaw) {
+			// complete block, decompressed directly into the result
+			if (!codec.decompress(compressed, sizeCompressed, target, sizeRaw)) {
+				data.clear();
+				return false;
+			}
+		}
+		else {
+			block.resize(sizeRaw);
+			if (!codec.decompress(compressed, sizeCompressed, block.data(), sizeRaw)) {
+				data.clear();
+				return false;
+			}
+			memcpy(target, &block[(size_t)(copyStart - offsetRaw)], (size_t)(copyEnd - copyStart));
+		}
+	}
+
+	return true;
+}
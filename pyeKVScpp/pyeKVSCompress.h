@@ -0,0 +1,171 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : block compression of pyeKVS documents and payloads
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Compressed stream
+* Name			type			size in byte		usage
+* Magic			char[4]			4					"PYEZ"
+* CodecId		UInt8			1					id of the codec (PyeCodec::getId)
+* BlockSize		UInt32			4					size of the uncompressed blocks; the last block can be smaller
+* RawSize		UInt64			8					size of the uncompressed data
+* CountBlocks	UInt32			4					count of blocks
+* BlockEnd0		UInt64			8					end of block 0, relative to the start of block 0
+* BlockEnd1		UInt64			8					end of block 1
+* Block0		bytes							compressed data of block 0; raw, if it has the uncompressed size
+* Block1		bytes
+*
+* Every block is compressed on its own, a byte range is decoded from the blocks which contain the range.
+*/
+
+/// <summary>
+/// Interface of a codec for the block compression.
+/// A codec compresses and decompresses single blocks; it has no state between the blocks.
+/// </summary>
+class PyeCodec {
+public:
+	virtual ~PyeCodec() {}
+
+	/// <summary>
+	/// Gets the id of the codec, which is stored in the compressed stream.
+	/// </summary>
+	/// <returns>id</returns>
+	virtual unsigned __int8 getId() const = 0;
+
+	/// <summary>
+	/// Compresses a block and appends the compressed data.
+	/// </summary>
+	/// <param name="data">pointer to the uncompressed data</param>
+	/// <param name="size">size of the uncompressed data</param>
+	/// <param name="compressed">vector for the compressed data; the data is appended</param>
+	virtual void compress(const unsigned char* data, size_t size, std::vector<unsigned char>& compressed) const = 0;
+
+	/// <summary>
+	/// Decompresses a block.
+	/// </summary>
+	/// <param name="compressed">pointer to the compressed data</param>
+	/// <param name="sizeCompressed">size of the compressed data</param>
+	/// <param name="data">pointer to the memory for the uncompressed data</param>
+	/// <param name="size">size of the uncompressed data</param>
+	/// <returns>false, if the compressed data is not valid</returns>
+	virtual bool decompress(const unsigned char* compressed, size_t sizeCompressed, unsigned char* data, size_t size) const = 0;
+};
+
+/// <summary>
+/// Fast LZ77 codec in the style of LZ4: byte-aligned sequences of literals and matches
+/// with a 16 bit offset, found by a hash table of 4 byte sequences.
+/// The decompression copies literals and matches without bit operations.
+/// </summary>
+class PyeCodecLZ : public PyeCodec {
+public:
+	virtual unsigned __int8 getId() const {
+		return 1;
+	}
+
+	virtual void compress(const unsigned char* data, size_t size, std::vector<unsigned char>& compressed) const;
+
+	virtual bool decompress(const unsigned char* compressed, size_t sizeCompressed, unsigned char* data, size_t size) const;
+};
+
+/// <summary>
+/// Block compression of byte streams, e.g. of a complete pyeKVS document or of the payload of a pyeMemory.
+/// The data is split into blocks of a fixed size, every block is compressed on its own.
+/// A block table in front of the blocks gives random access at block granularity.
+/// </summary>
+class PyeBlockCompression {
+public:
+	/// <summary> Default size of the blocks </summary>
+	static const unsigned __int32 defaultBlockSize = 64 * 1024;
+
+	/// <summary>
+	/// Compresses a byte stream.
+	/// </summary>
+	/// <param name="data">pointer to the data</param>
+	/// <param name="size">size of the data</param>
+	/// <param name="stream">vector for the compressed stream; cleared before</param>
+	/// <param name="codec">codec of the blocks</param>
+	/// <param name="blockSize">size of the uncompressed blocks</param>
+	static void encode(const unsigned char* data, unsigned __int64 size, std::vector<unsigned char>& stream,
+		const PyeCodec& codec = PyeCodecLZ(), unsigned __int32 blockSize = defaultBlockSize);
+
+	static void encode(const std::vector<unsigned char>& data, std::vector<unsigned char>& stream,
+		const PyeCodec& codec = PyeCodecLZ(), unsigned __int32 blockSize = defaultBlockSize) {
+		encode(data.data(), data.size(), stream, codec, blockSize);
+	}
+
+	/// <summary>
+	/// Decompresses a complete stream.
+	/// </summary>
+	/// <param name="stream">pointer to the compressed stream</param>
+	/// <param name="sizeStream">size of the compressed stream</param>
+	/// <param name="data">vector for the data; cleared before</param>
+	/// <param name="codec">codec of the blocks</param>
+	/// <returns>false, if the stream is not valid or has another codec</returns>
+	static bool decode(const unsigned char* stream, unsigned __int64 sizeStream, std::vector<unsigned char>& data, const PyeCodec& codec = PyeCodecLZ()) {
+		unsigned __int64 size;
+		if (!getRawSize(stream, sizeStream, size)) {
+			return false;
+		}
+		return decodeRange(stream, sizeStream, 0, size, data, codec);
+	}
+
+	static bool decode(const std::vector<unsigned char>& stream, std::vector<unsigned char>& data, const PyeCodec& codec = PyeCodecLZ()) {
+		return decode(stream.data(), stream.size(), data, codec);
+	}
+
+	/// <summary>
+	/// Decompresses a byte range. Only the blocks which contain the range are decompressed.
+	/// </summary>
+	/// <param name="stream">pointer to the compressed stream</param>
+	/// <param name="sizeStream">size of the compressed stream</param>
+	/// <param name="offset">offset of the range in the uncompressed data</param>
+	/// <param name="size">size of the range</param>
+	/// <param name="data">vector for the data of the range; cleared before</param>
+	/// <param name="codec">codec of the blocks</param>
+	/// <returns>false, if the stream is not valid, has another codec or the range is out of the data</returns>
+	static bool decodeRange(const unsigned char* stream, unsigned __int64 sizeStream, unsigned __int64 offset, unsigned __int64 size,
+		std::vector<unsigned char>& data, const PyeCodec& codec = PyeCodecLZ());
+
+	/// <summary>
+	/// Gets the size of the uncompressed data.
+	/// </summary>
+	/// <param name="stream">pointer to the compressed stream</param>
+	/// <param name="sizeStream">size of the compressed stream</param>
+	/// <param name="size">size of the uncompressed data</param>
+	/// <returns>false, if the stream is not valid</returns>
+	static bool getRawSize(const unsigned char* stream, unsigned __int64 sizeStream, unsigned __int64& size);
+
+	/// <summary>
+	/// Puts a byte stream compressed as pyeMemory to a list.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	/// <param name="key">key name</param>
+	/// <param name="data">uncompressed data</param>
+	/// <param name="codec">codec of the blocks</param>
+	/// <param name="blockSize">size of the uncompressed blocks</param>
+	static void putMemory(PyeList& list, const std::string& key, const std::vector<unsigned char>& data,
+		const PyeCodec& codec = PyeCodecLZ(), unsigned __int32 blockSize = defaultBlockSize) {
+		std::vector<unsigned char> stream;
+		encode(data, stream, codec, blockSize);
+		list.putMemory(stream, key);
+	}
+
+private:
+	/// <summary> Size of the header: magic, codec id, block size, raw size and count of blocks </summary>
+	static const unsigned __int64 sizeHeader = 21;
+};
@@ -0,0 +1,201 @@
+//#include "pch.h"
+
+#include <vector>
+#include <map>
+#include <set>
+
+#include "pyeKVSDiff.h"
+
+
+PyeDocument PyeDiff::diff(PyeDocument& docOld, PyeDocument& docNew) {
+	PyeDocument docPatch;
+
+	diffList(docOld.getRoot(), docNew.getRoot(), docPatch.getRoot());
+
+	return docPatch;
+}
+
+PyeDocument PyeDiff::patch(PyeDocument& docOld, PyeDocument& docPatch) {
+	PyeDocument docResult;
+
+	patchList(docOld.getRoot(), docPatch.getRoot(), docResult.getRoot());
+
+	return docResult;
+}
+
+bool PyeDiff::diffList(PyeList& listOld, PyeList& listNew, PyeList& listPatch) {
+	const PyeItemIdx& idxOld = listOld.getItemIdx();
+	const PyeItemIdx& idxNew = listNew.getItemIdx();
+
+	std::vector<unsigned __int64> puts;
+	std::vector<std::string> dels;
+	std::vector<std::string> subs;
+
+	for (const auto& item : idxNew) {
+		// reserved objects describe their own list and are not part of a patch
+		if (pyeIsReservedKey(item.first)) {
+			continue;
+		}
+
+		auto itemOld = idxOld.find(item.first);
+		if (itemOld == idxOld.end()) {
+			puts.push_back(item.second);
+			continue;
+		}
+
+		if (isEqualValue(*listOld.getBuffer(), itemOld->second, *listNew.getBuffer(), item.second)) {
+			continue;
+		}
+
+		if (readValueType(*listOld.getBuffer(), itemOld->second) == pyeValueType::pyeList
+			&& readValueType(*listNew.getBuffer(), item.second) == pyeValueType::pyeList) {
+			subs.push_back(item.first);
+		}
+		else {
+			puts.push_back(item.second);
+		}
+	}
+
+	for (const auto& item : idxOld) {
+		if (idxNew.find(item.first) == idxNew.end() && !pyeIsReservedKey(item.first)) {
+			dels.push_back(item.first);
+		}
+	}
+
+	if (puts.empty() && dels.empty() && subs.empty()) {
+		return false;
+	}
+
+	if (!puts.empty()) {
+		// keep the order of the new document
+		std::sort(puts.begin(), puts.end());
+
+		PyeList listPut = listPatch.putList(Str_PYEKVSPatchPut);
+		listPut.putRaw(*listNew.getBuffer(), puts);
+	}
+
+	if (!dels.empty()) {
+		PyeList listDel = listPatch.putList(Str_PYEKVSPatchDel);
+		for (const std::string& key : dels) {
+			listDel.putZero(key);
+		}
+	}
+
+	if (!subs.empty()) {
+		PyeList listSub = listPatch.putList(Str_PYEKVSPatchSub);
+		for (const std::string& key : subs) {
+			PyeList subOld = listOld.getList(key);
+			PyeList subNew = listNew.getList(key);
+			PyeList subPatch = listSub.putList(key);
+			diffList(subOld, subNew, subPatch);
+		}
+	}
+
+	return true;
+}
+
+void PyeDiff::patchList(PyeList& listOld, PyeList& listPatch, PyeList& listResult) {
+	const PyeItemIdx& idxPatch = listPatch.getItemIdx();
+
+	PyeList listPut;
+	PyeList listDel;
+	PyeList listSub;
+	bool hasPut = idxPatch.count(Str_PYEKVSPatchPut) > 0;
+	bool hasDel = idxPatch.count(Str_PYEKVSPatchDel) > 0;
+	bool hasSub = idxPatch.count(Str_PYEKVSPatchSub) > 0;
+
+	if (hasPut) listPut = listPatch.getList(Str_PYEKVSPatchPut);
+	if (hasDel) listDel = listPatch.getList(Str_PYEKVSPatchDel);
+	if (hasSub) listSub = listPatch.getList(Str_PYEKVSPatchSub);
+
+	std::vector<unsigned char>& bufferOld = *listOld.getBuffer();
+	std::set<std::string> keysPut;
+
+	// unchanged objects are collected and copied in one step
+	std::vector<unsigned __int64> pending;
+
+	for (unsigned __int64 offsetObject : listOld.getItemOffsets()) {
+		std::string key = readKey(bufferOld, offsetObject);
+
+		if (pyeIsReservedKey(key)) {
+			continue;
+		}
+
+		if (hasDel && listDel.getItemIdx().count(key) > 0) {
+			continue;
+		}
+
+		if (hasPut) {
+			auto itemPut = listPut.getItemIdx().find(key);
+			if (itemPut != listPut.getItemIdx().end()) {
+				if (!pending.empty()) {
+					listResult.putRaw(bufferOld, pending);
+					pending.clear();
+				}
+				listResult.putRaw(*listPut.getBuffer(), itemPut->second);
+				keysPut.insert(key);
+				continue;
+			}
+		}
+
+		if (hasSub && listSub.getItemIdx().count(key) > 0 && readValueType(bufferOld, offsetObject) == pyeValueType::pyeList) {
+			if (!pending.empty()) {
+				listResult.putRaw(bufferOld, pending);
+				pending.clear();
+			}
+			PyeList subOld = listOld.getList(key);
+			PyeList subPatch = listSub.getList(key);
+			PyeList subResult = listResult.putList(key);
+			patchList(subOld, subPatch, subResult);
+			continue;
+		}
+
+		pending.push_back(offsetObject);
+	}
+
+	if (!pending.empty()) {
+		listResult.putRaw(bufferOld, pending);
+	}
+
+	// new keys
+	if (hasPut) {
+		std::vector<unsigned __int64> added;
+		for (const auto& item : listPut.getItemIdx()) {
+			if (keysPut.count(item.first) == 0) {
+				added.push_back(item.second);
+			}
+		}
+
+		if (!added.empty()) {
+			std::sort(added.begin(), added.end());
+			listResult.putRaw(*listPut.getBuffer(), added);
+		}
+	}
+}
+
+bool PyeDiff::isEqualValue(std::vector<unsigned char>& bufferA, unsigned __int64 offsetObjectA, std::vector<unsigned char>& bufferB, unsigned __int64 offsetObjectB) {
+	unsigned __int64 offsetValueA = offsetObjectA + 1 /*information key size*/ + bufferA[offsetObjectA];
+	unsigned __int64 offsetValueB = offsetObjectB + 1 /*information key size*/ + bufferB[offsetObjectB];
+	unsigned __int64 sizeA = getOffsetValueEnd(bufferA, offsetValueA) - offsetValueA;
+	unsigned __int64 sizeB = getOffsetValueEnd(bufferB, offsetValueB) - offsetValueB;
+
+	if (sizeA != sizeB) {
+		return false;
+	}
+
+	return memcmp(&bufferA[offsetValueA], &bufferB[offsetValueB], sizeA) == 0;
+}
+
+std::string PyeDiff::readKey(std::vector<unsigned char>& buffer, unsigned __int64 offsetObject) {
+	unsigned __int8 keySize;
+	ReadFromVector(keySize, buffer, offsetObject);
+
+	std::string key(&buffer[offsetObject + 1], &buffer[offsetObject + 1] + keySize);
+	return key;
+}
+
+pyeValueType PyeDiff::readValueType(std::vector<unsigned char>& buffer, unsigned __int64 offsetObject) {
+	pyeValueType valueType;
+	ReadFromVector(valueType, buffer, offsetObject + 1 /*information key size*/ + buffer[offsetObject]);
+	return valueType;
+}
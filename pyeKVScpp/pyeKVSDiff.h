@@ -0,0 +1,95 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : structural diff and patch of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* pyeKVS patch
+* A patch is a normal pyeKVS document. Every list of the patch describes the changes
+* of one list of the old document and holds up to three sub-lists:
+* Name		type		usage
+* put		pyeList		objects to add or to replace; encoded bytes copied from the new document
+* del		pyeList		keys to remove; value type pyeZero
+* sub		pyeList		patches of changed sub-lists; one pyeList per key with the same structure
+* Lists without changes are not part of the patch.
+*/
+
+/// <summary>
+/// Key names of the sub-lists of a pyeKVS patch.
+/// </summary>
+const char Str_PYEKVSPatchPut[] = "put";
+const char Str_PYEKVSPatchDel[] = "del";
+const char Str_PYEKVSPatchSub[] = "sub";
+
+/// <summary>
+/// Compares two pyeKVS documents list by list and creates a compact patch.
+/// The patch is a pyeKVS document itself and can be applied to the old document
+/// to get the new document. Values are compared and copied as encoded bytes.
+/// </summary>
+class PyeDiff {
+public:
+	/// <summary>
+	/// Creates the patch between two pyeKVS documents.
+	/// </summary>
+	/// <param name="docOld">old pyeKVS document</param>
+	/// <param name="docNew">new pyeKVS document</param>
+	/// <returns>pyeKVS document with the patch</returns>
+	static PyeDocument diff(PyeDocument& docOld, PyeDocument& docNew);
+
+	/// <summary>
+	/// Applies a patch to a pyeKVS document.
+	/// </summary>
+	/// <param name="docOld">old pyeKVS document</param>
+	/// <param name="docPatch">pyeKVS document with the patch</param>
+	/// <returns>new pyeKVS document</returns>
+	static PyeDocument patch(PyeDocument& docOld, PyeDocument& docPatch);
+
+private:
+	/// <summary>
+	/// Writes the changes between two lists to the patch list.
+	/// </summary>
+	/// <param name="listOld">list of the old document</param>
+	/// <param name="listNew">list of the new document</param>
+	/// <param name="listPatch">list of the patch document</param>
+	/// <returns>true, if the lists are different</returns>
+	static bool diffList(PyeList& listOld, PyeList& listNew, PyeList& listPatch);
+
+	/// <summary>
+	/// Writes the items of the old list with the changes of the patch list to the result list.
+	/// </summary>
+	/// <param name="listOld">list of the old document</param>
+	/// <param name="listPatch">list of the patch document</param>
+	/// <param name="listResult">list of the new document</param>
+	static void patchList(PyeList& listOld, PyeList& listPatch, PyeList& listResult);
+
+	/// <summary>
+	/// Compares the encoded values of two pyeKVS objects.
+	/// </summary>
+	/// <returns>true, if value type and value bytes are equal</returns>
+	static bool isEqualValue(std::vector<unsigned char>& bufferA, unsigned __int64 offsetObjectA, std::vector<unsigned char>& bufferB, unsigned __int64 offsetObjectB);
+
+	/// <summary>
+	/// Reads the key of a encoded pyeKVS object.
+	/// </summary>
+	static std::string readKey(std::vector<unsigned char>& buffer, unsigned __int64 offsetObject);
+
+	/// <summary>
+	/// Reads the pye value type of a encoded pyeKVS object.
+	/// </summary>
+	static pyeValueType readValueType(std::vector<unsigned char>& buffer, unsigned __int64 offsetObject);
+};
@@ -0,0 +1,177 @@
+//#include "pch.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+
+#include "pyeKVSDirectory.h"
+
+
+void PyeKeyDirectory::put(PyeList& list) {
+	std::vector<std::pair<unsigned __int64, unsigned __int32>> entries;
+	entries.reserve(list.getItemIdx().size());
+
+	for (const auto& item : list.getItemIdx()) {
+		if (pyeIsReservedKey(item.first)) {
+			continue;
+		}
+		entries.push_back(std::make_pair(pyeHashKey(item.first), (unsigned __int32)(item.second - list.getOffsetObject())));
+	}
+
+	std::sort(entries.begin(), entries.end());
+
+	std::vector<unsigned char> directory;
+	directory.reserve(4 /*count*/ + entries.size() * sizeEntry + 8 /*size of the list and the object*/);
+
+	unsigned __int32 count = (unsigned __int32)entries.size();
+	WriteToVector(directory, count, directory.size());
+
+	for (auto& entry : entries) {
+		WriteToVector(directory, entry.first, directory.size());
+		WriteToVector(directory, entry.second, directory.size());
+	}
+
+	putTrailingObject(list, Str_PYEKVSKeyDirectory, directory);
+}
+
+void PyeKeyDirectory::putTrailingObject(PyeList& list, const std::string& key, std::vector<unsigned char>& data) {
+	unsigned __int32 sizeObject = (unsigned __int32)(1 /*information key size*/ + key.size()
+		+ 1 /*pye value type*/ + 4 /*memory size*/ + data.size() + 8 /*size of the list and the object*/);
+
+	// size of the list after the put
+	unsigned __int32 sizeList = list.getSize() + sizeObject;
+	WriteToVector(data, sizeList, data.size());
+	WriteToVector(data, sizeObject, data.size());
+
+	list.putMemory(data, key);
+}
+
+bool PyeKeyDirectory::findTrailingObject(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetData, unsigned __int64& sizeData) {
+	if (offsetList >= size) {
+		return false;
+	}
+
+	unsigned __int64 offsetValue = offsetList + 1 /*information key size*/ + data[offsetList];
+	if (offsetValue + 9 /*list header*/ > size || data[offsetValue] != pyeValueType::pyeList) {
+		return false;
+	}
+
+	unsigned __int32 listSize;
+	memcpy(&listSize, &data[offsetValue + 1 /*pye value type*/], sizeof(listSize));
+
+	unsigned __int64 listEnd = offsetValue + 9 /*list header*/ + listSize;
+	if (listSize < 8 || listEnd > size) {
+		return false;
+	}
+
+	// the last 4 bytes of the list give the size of the object
+	unsigned __int32 sizeObject;
+	memcpy(&sizeObject, &data[listEnd - 4], sizeof(sizeObject));
+
+	unsigned __int64 sizeHeader = 1 /*information key size*/ + key.size() + 1 /*pye value type*/ + 4 /*memory size*/;
+	if (sizeObject > listSize || sizeObject < sizeHeader + 8 /*size of the list and the object*/) {
+		return false;
+	}
+
+	// the object of a sub-list, which is the last item of the list, ends at the same byte
+	unsigned __int32 sizeListObject;
+	memcpy(&sizeListObject, &data[listEnd - 8], sizeof(sizeListObject));
+	if (sizeListObject != listSize) {
+		return false;
+	}
+
+	unsigned __int64 offsetObject = listEnd - sizeObject;
+	if (data[offsetObject] != key.size()
+		|| memcmp(&data[offsetObject + 1], key.data(), key.size()) != 0
+		|| data[offsetObject + 1 + key.size()] != pyeValueType::pyeMemory) {
+		return false;
+	}
+
+	offsetData = offsetObject + sizeHeader;
+	sizeData = sizeObject - sizeHeader - 8 /*size of the list and the object*/;
+	return true;
+}
+
+bool PyeKeyDirectory::findDirectory(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, unsigned __int64& offsetEntries, unsigned __int32& count) {
+	unsigned __int64 offsetData;
+	unsigned __int64 sizeData;
+	if (!findTrailingObject(data, size, offsetList, Str_PYEKVSKeyDirectory, offsetData, sizeData) || sizeData < 4) {
+		return false;
+	}
+
+	memcpy(&count, &data[offsetData], sizeof(count));
+	if (4 /*count*/ + count * sizeEntry != sizeData) {
+		return false;
+	}
+
+	offsetEntries = offsetData + 4 /*count*/;
+	return true;
+}
+
+bool PyeKeyDirectory::find(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetObject) {
+	unsigned __int64 offsetEntries;
+	unsigned __int32 count;
+	if (!findDirectory(data, size, offsetList, offsetEntries, count)) {
+		return false;
+	}
+
+	unsigned __int64 hash = pyeHashKey(key);
+
+	// binary search of the first entry with the hash
+	unsigned __int32 first = 0;
+	unsigned __int32 last = count;
+	while (first < last) {
+		unsigned __int32 middle = first + (last - first) / 2;
+
+		unsigned __int64 hashEntry;
+		memcpy(&hashEntry, &data[offsetEntries + middle * sizeEntry], sizeof(hashEntry));
+
+		if (hashEntry < hash) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+
+	// entries with the same hash are compared with the key
+	for (unsigned __int32 i = first; i < count; i++) {
+		unsigned __int64 hashEntry;
+		memcpy(&hashEntry, &data[offsetEntries + i * sizeEntry], sizeof(hashEntry));
+		if (hashEntry != hash) {
+			break;
+		}
+
+		unsigned __int32 offsetEntry;
+		memcpy(&offsetEntry, &data[offsetEntries + i * sizeEntry + 8], sizeof(offsetEntry));
+
+		unsigned __int64 offsetItem = offsetList + offsetEntry;
+		if (offsetItem + 1 + key.size() <= size && data[offsetItem] == key.size()
+			&& memcmp(&data[offsetItem + 1], key.data(), key.size()) == 0) {
+			offsetObject = offsetItem;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool PyeKeyDirectory::getItemIdx(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, PyeItemIdx& itemIdx) {
+	unsigned __int64 offsetEntries;
+	unsigned __int32 count;
+	if (!findDirectory(data, size, offsetList, offsetEntries, count)) {
+		return false;
+	}
+
+	for (unsigned __int32 i = 0; i < count; i++) {
+		unsigned __int32 offsetEntry;
+		memcpy(&offsetEntry, &data[offsetEntries + i * sizeEntry + 8], sizeof(offsetEntry));
+
+		if (!addItem(data, size, offsetList + offsetEntry, itemIdx)) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,168 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : sorted key directories for fast key lookups in encoded pyeLists
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Key directory of a pyeList
+* The directory is the last object of the list, a pyeMemory with a reserved key.
+* Name			type			size in byte	usage
+* Count			UInt32			4				count of entries
+* Entry0		Hash UInt64		8				hash of the key (pyeHashKey)
+*				Offset UInt32	4				offset of the object relative to the offset of the list object
+* Entry1		...
+* ListSize		UInt32			4				size of the list (Size of the list header) with the directory
+* Size			UInt32			4				size of the complete directory object (key, value type and value)
+*
+* The entries are sorted by hash. The size at the end of the list gives the start of the directory,
+* so a reader finds the directory from the header of the list without decoding the items.
+* The list size tells the directory of the list from a directory of a sub-list, which ends at the same byte.
+*/
+
+/// <summary> Reserved key of the key directory object </summary>
+const std::string Str_PYEKVSKeyDirectory = std::string(1, Str_PYEKVSReservedKeyPrefix) + "dir";
+
+/// <summary>
+/// Hash of a key: FNV-1a (64 bit) with a final mix of the bits.
+/// </summary>
+/// <param name="key">chars of the key</param>
+/// <param name="keySize">count of chars</param>
+/// <param name="seed">seed for independent hash functions</param>
+/// <returns>hash</returns>
+inline unsigned __int64 pyeHashKey(const unsigned char* key, size_t keySize, unsigned __int64 seed = 0) {
+	unsigned __int64 hash = 14695981039346656037ULL ^ seed;
+	for (size_t i = 0; i < keySize; i++) {
+		hash ^= key[i];
+		hash *= 1099511628211ULL;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+inline unsigned __int64 pyeHashKey(const std::string& key, unsigned __int64 seed = 0) {
+	return pyeHashKey((const unsigned char*)key.data(), key.size(), seed);
+}
+
+/// <summary>
+/// Sorted key directory of a pyeList for write-once documents.
+/// The directory is appended to a complete list and stored with the document.
+/// A reader looks up a key with a binary search over the hashes, directly in the byte stream
+/// (e.g. a mapped file), without decoding the list.
+/// </summary>
+class PyeKeyDirectory {
+public:
+	/// <summary>
+	/// Appends the key directory of all items to the list.
+	/// The list must be complete and the last object in the byte stream;
+	/// items put after the directory are not found by the directory.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	static void put(PyeList& list);
+
+	/// <summary>
+	/// Checks if a list has a valid key directory.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <returns>true, if the list ends with a key directory</returns>
+	static bool hasDirectory(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList) {
+		unsigned __int64 offsetEntries;
+		unsigned __int32 count;
+		return findDirectory(data, size, offsetList, offsetEntries, count);
+	}
+
+	static bool hasDirectory(const std::vector<unsigned char>& buffer, unsigned __int64 offsetList) {
+		return hasDirectory(buffer.data(), buffer.size(), offsetList);
+	}
+
+	/// <summary>
+	/// Finds the object of a key with the key directory of the list.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <param name="key">key name</param>
+	/// <param name="offsetObject">offset of the pyeKVS object of the key, if found</param>
+	/// <returns>true, if found; false, if the key or the key directory does not exist</returns>
+	static bool find(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetObject);
+
+	static bool find(const std::vector<unsigned char>& buffer, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetObject) {
+		return find(buffer.data(), buffer.size(), offsetList, key, offsetObject);
+	}
+
+	/// <summary>
+	/// Gets the keys and the offsets of all objects of the list from the key directory, without decoding the list.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <param name="itemIdx">map to fill with key and offset of the pyeKVS objects</param>
+	/// <returns>false, if the key directory does not exist</returns>
+	static bool getItemIdx(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, PyeItemIdx& itemIdx);
+
+	/// <summary>
+	/// Reads the key of a pyeKVS object and adds key and offset to a map.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetObject">offset of the pyeKVS object</param>
+	/// <param name="itemIdx">map of key and offset of the pyeKVS objects</param>
+	/// <returns>false, if the key is not inside the byte stream</returns>
+	static bool addItem(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetObject, PyeItemIdx& itemIdx) {
+		if (offsetObject >= size || offsetObject + 1 + data[offsetObject] > size) {
+			return false;
+		}
+
+		itemIdx.insert(std::make_pair(std::string((const char*)&data[offsetObject + 1], data[offsetObject]), offsetObject));
+		return true;
+	}
+
+	/// <summary>
+	/// Appends a reserved object as last object to a list: a pyeMemory with the data,
+	/// followed by the size of the list and the size of the complete object, so the object is found from the end of the list.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	/// <param name="key">reserved key of the object</param>
+	/// <param name="data">data of the object; the size of the list and the size of the object are appended</param>
+	static void putTrailingObject(PyeList& list, const std::string& key, std::vector<unsigned char>& data);
+
+	/// <summary>
+	/// Finds a reserved object, which was appended with putTrailingObject, at the end of a list.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <param name="key">reserved key of the object</param>
+	/// <param name="offsetData">offset of the data of the object</param>
+	/// <param name="sizeData">size of the data without the size of the list and the size of the object</param>
+	/// <returns>true, if the list ends with the object</returns>
+	static bool findTrailingObject(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetData, unsigned __int64& sizeData);
+
+private:
+	/// <summary> Size of one entry: hash (8 bytes) and offset (4 bytes) </summary>
+	static const unsigned __int64 sizeEntry = 12;
+
+	/// <summary>
+	/// Finds and checks the key directory at the end of the list.
+	/// </summary>
+	static bool findDirectory(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, unsigned __int64& offsetEntries, unsigned __int32& count);
+};
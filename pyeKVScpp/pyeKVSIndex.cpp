@@ -0,0 +1,104 @@
+//#include "pch.h"
+
+#include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "pyeKVSIndex.h"
+
+
+void PyeDocumentIndex::build(const PyeByteSpan& data, unsigned __int64 offsetRootList, unsigned int threads) {
+	_lists.clear();
+
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	std::mutex mutexTasks;
+	std::condition_variable cvTasks;
+	std::deque<unsigned __int64> tasks;
+	unsigned __int64 tasksInWork = 0;
+
+	tasks.push_back(offsetRootList);
+
+	// every thread collects its own results, merged after the join
+	std::vector<std::vector<std::pair<unsigned __int64, std::shared_ptr<const ItemIdx>>>> results(threads);
+
+	auto worker = [&](unsigned int idThread) {
+		std::vector<unsigned __int64> subLists;
+
+		for (;;) {
+			unsigned __int64 offsetList;
+			{
+				std::unique_lock<std::mutex> lock(mutexTasks);
+				cvTasks.wait(lock, [&]() { return !tasks.empty() || tasksInWork == 0; });
+				if (tasks.empty()) {
+					// no open tasks and no thread in work, which can add new tasks
+					return;
+				}
+				// newest task first, the sub-lists of a list are near in the byte stream
+				offsetList = tasks.back();
+				tasks.pop_back();
+				tasksInWork++;
+			}
+
+			std::shared_ptr<ItemIdx> itemIdx = std::make_shared<ItemIdx>();
+			subLists.clear();
+			decodeList(data, offsetList, *itemIdx, &subLists);
+			results[idThread].push_back(std::make_pair(offsetList, std::shared_ptr<const ItemIdx>(itemIdx)));
+
+			{
+				std::lock_guard<std::mutex> lock(mutexTasks);
+				tasks.insert(tasks.end(), subLists.begin(), subLists.end());
+				tasksInWork--;
+			}
+			cvTasks.notify_all();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < threads; i++) {
+		pool.push_back(std::thread(worker, i));
+	}
+	worker(0);
+
+	for (std::thread& thread : pool) {
+		thread.join();
+	}
+
+	for (const auto& result : results) {
+		_lists.insert(result.begin(), result.end());
+	}
+}
+
+void PyeDocumentIndex::decodeList(const PyeByteSpan& buffer, unsigned __int64 offsetList, ItemIdx& itemIdx, std::vector<unsigned __int64>* subLists) {
+	itemIdx.clear();
+
+	unsigned __int64 idx = offsetList + 1 /*information size of key*/ + buffer[offsetList];
+
+	unsigned __int32 listSize;
+	ReadFromVector(listSize, buffer, idx + 1 /*pyeValueType(1 byte)*/);
+
+	idx += 1 /*size of pyeValueType*/ + 4 /*size of list size*/ + 4 /*size of list count*/;
+	unsigned __int64 listEnd = idx + listSize;
+
+	while (idx < listEnd) {
+		unsigned __int64 idxStart = idx;
+
+		unsigned __int8 keySize;
+		ReadFromVector(keySize, buffer, idx);
+		idx += sizeof(keySize);
+
+		itemIdx.insert(std::pair<std::string, unsigned __int64>(std::string(&buffer[idx], &buffer[idx] + keySize), idxStart));
+		idx += keySize;
+
+		if (subLists && buffer[idx] == pyeValueType::pyeList) {
+			subLists->push_back(idxStart);
+		}
+
+		idx = getOffsetValueEnd(buffer, idx);
+	}
+}
@@ -0,0 +1,88 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : parallel indexing of the lists of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/// <summary>
+/// Index of all pyeLists of a pyeKVS document.
+/// Every list is stored with its offset in the byte stream and the index of its items (key and offset).
+/// The size header of a list gives the byte range of the list, so every list is decoded on its own.
+/// The build is done by a pool of threads: every decoded list adds its sub-lists as new tasks.
+/// After the build the index is not changed anymore and can be shared by several threads.
+/// </summary>
+class PyeDocumentIndex {
+public:
+	/// <summary> Index of the items of one list: key and offset of the pyeKVS object </summary>
+	typedef PyeItemIdx ItemIdx;
+
+	PyeDocumentIndex() {}
+
+	/// <summary>
+	/// Builds the index of all lists of a pyeKVS byte stream.
+	/// </summary>
+	/// <param name="data">byte stream</param>
+	/// <param name="offsetRootList">offset of the root list; default behind the document header</param>
+	/// <param name="threads">count of threads; 0 uses the count of cores</param>
+	void build(const PyeByteSpan& data, unsigned __int64 offsetRootList = 16, unsigned int threads = 0);
+
+	/// <summary>
+	/// Builds the index of all lists of a pyeKVS buffer.
+	/// </summary>
+	/// <param name="buffer">pointer to the byte stream</param>
+	/// <param name="offsetRootList">offset of the root list; default behind the document header</param>
+	/// <param name="threads">count of threads; 0 uses the count of cores</param>
+	void build(const std::vector<unsigned char>* buffer, unsigned __int64 offsetRootList = 16, unsigned int threads = 0) {
+		build(PyeByteSpan(*buffer), offsetRootList, threads);
+	}
+
+	/// <summary>
+	/// Gets the index of the items of a list.
+	/// </summary>
+	/// <param name="offsetList">offset of the pyeList object in the byte stream</param>
+	/// <returns>index of the items; nullptr if the list is not in the index</returns>
+	std::shared_ptr<const ItemIdx> getItemIdx(unsigned __int64 offsetList) const {
+		auto list = _lists.find(offsetList);
+		if (list == _lists.end()) {
+			return nullptr;
+		}
+		return list->second;
+	}
+
+	/// <summary>
+	/// Gets the count of indexed lists.
+	/// </summary>
+	/// <returns>count of lists</returns>
+	size_t getCountLists() const {
+		return _lists.size();
+	}
+
+	/// <summary>
+	/// Decodes the items of one list.
+	/// </summary>
+	/// <param name="buffer">byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object in the byte stream</param>
+	/// <param name="itemIdx">index to fill with the items of the list</param>
+	/// <param name="subLists">optional: gets the offsets of all sub-lists of the list</param>
+	static void decodeList(const PyeByteSpan& buffer, unsigned __int64 offsetList, ItemIdx& itemIdx, std::vector<unsigned __int64>* subLists = nullptr);
+
+private:
+	/// <summary> Index of all lists by the offset of the list </summary>
+	std::unordered_map<unsigned __int64, std::shared_ptr<const ItemIdx>> _lists;
+};
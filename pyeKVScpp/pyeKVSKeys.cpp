@@ -0,0 +1,83 @@
+//#include "pch.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "pyeKVSKeys.h"
+
+
+PyeKey PyeKeyDictionary::intern(const std::string& name) {
+	auto it = _ids.find(name);
+	if (it != _ids.end()) {
+		return PyeKey(it->second);
+	}
+
+	// the dictionary stores key names with the size of a key (uint8)
+	if (_names.size() >= maxCount || name.size() > 255) {
+		return PyeKey(name);
+	}
+
+	unsigned __int16 id = (unsigned __int16)_names.size();
+	_names.push_back(name);
+	_ids.insert(std::make_pair(name, id));
+	return PyeKey(id);
+}
+
+bool PyeKeyDictionary::find(const std::string& name, PyeKey& key) const {
+	auto it = _ids.find(name);
+	if (it == _ids.end()) {
+		key = PyeKey(name);
+		return false;
+	}
+
+	key = PyeKey(it->second);
+	return true;
+}
+
+const std::string& PyeKeyDictionary::getName(unsigned __int16 id) const {
+	static const std::string nameEmpty;
+	return id < _names.size() ? _names[id] : nameEmpty;
+}
+
+void PyeKeyDictionary::encode(std::vector<unsigned char>& data) const {
+	data.clear();
+
+	unsigned __int32 count = (unsigned __int32)_names.size();
+	WriteToVector(data, count, data.size());
+
+	for (const std::string& name : _names) {
+		data.push_back((unsigned char)name.size());
+		data.insert(data.end(), name.begin(), name.end());
+	}
+}
+
+bool PyeKeyDictionary::decode(const unsigned char* data, size_t size) {
+	clear();
+
+	unsigned __int32 count;
+	if (size < sizeof(count)) {
+		return false;
+	}
+	memcpy(&count, data, sizeof(count));
+	if (count > maxCount) {
+		return false;
+	}
+
+	size_t pos = sizeof(count);
+	_names.reserve(count);
+	for (unsigned __int32 i = 0; i < count; i++) {
+		if (pos >= size || pos + 1 + data[pos] > size) {
+			clear();
+			return false;
+		}
+
+		std::string name((const char*)&data[pos + 1], data[pos]);
+		pos += 1 + data[pos];
+
+		_ids.insert(std::make_pair(name, (unsigned __int16)i));
+		_names.push_back(std::move(name));
+	}
+
+	return true;
+}
@@ -0,0 +1,227 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : key dictionary and interned keys of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/// <summary> Key of the reserved object with the key dictionary in the root list </summary>
+const std::string Str_PYEKVSKeyDictionary = std::string(1, Str_PYEKVSReservedKeyPrefix) + "keys";
+
+/*
+* Key dictionary (pyeMemory "\0keys" in the root list)
+* Name			type			size in byte	usage
+* Count			UInt32			4				count of keys
+* Key0			Size UInt8		1				size of the key name
+*				Name			Size			key name
+* Key1			...
+* The id of a key is its position in the dictionary.
+*/
+
+/// <summary>
+/// Handle of a key for puts and gets. An interned key is stored with 3 bytes in the byte stream
+/// and compared by its id; a key, which is not interned (the dictionary is full), holds the key name.
+/// A key name with the prefix of interned keys is escaped, so it never collides with an interned key.
+/// The handle converts to the key string of the byte stream, so it is used with all puts and gets of pyeList and PyeListView.
+/// </summary>
+class PyeKey {
+	/// <summary> Key in the byte stream: interned key or key name </summary>
+	std::string _key;
+
+	/// <summary> Id of the key in the key dictionary; idNone, if the key is not interned </summary>
+	unsigned __int16 _id = idNone;
+
+public:
+	/// <summary> Id of a key, which is not interned </summary>
+	static const unsigned __int16 idNone = 0xFFFF;
+
+	/// <summary> Count of prefixes in front of an escaped key name; an escaped key is never 3 bytes long </summary>
+	static const size_t sizeEscape = 3;
+
+	PyeKey() {}
+
+	/// <summary>
+	/// Constructor of an interned key
+	/// </summary>
+	/// <param name="id">id of the key in the key dictionary</param>
+	explicit PyeKey(unsigned __int16 id) : _id(id) {
+		_key.resize(3);
+		_key[0] = Str_PYEKVSInternedKeyPrefix;
+		_key[1] = (char)(id & 0xFF);
+		_key[2] = (char)(id >> 8);
+	}
+
+	/// <summary>
+	/// Constructor of a key, which is not interned.
+	/// A key name, which starts with the prefix of interned keys, is escaped with more prefixes.
+	/// </summary>
+	/// <param name="name">key name</param>
+	explicit PyeKey(const std::string& name) : _key(name) {
+		if (!name.empty() && name[0] == Str_PYEKVSInternedKeyPrefix) {
+			_key.insert(0, sizeEscape, Str_PYEKVSInternedKeyPrefix);
+		}
+	}
+
+	/// <summary>
+	/// Checks if a key of the byte stream is an escaped key name.
+	/// </summary>
+	/// <param name="key">key of the byte stream</param>
+	/// <returns>true, if the key is a key name with the prefix of interned keys</returns>
+	static bool isEscaped(const std::string& key) {
+		return key.size() > sizeEscape && key.find_first_not_of(Str_PYEKVSInternedKeyPrefix) >= sizeEscape;
+	}
+
+	unsigned __int16 getId() const {
+		return _id;
+	}
+
+	bool isInterned() const {
+		return _id != idNone;
+	}
+
+	/// <summary>
+	/// Gets the key of the byte stream.
+	/// </summary>
+	const std::string& getKey() const {
+		return _key;
+	}
+
+	operator const std::string& () const {
+		return _key;
+	}
+
+	bool operator==(const PyeKey& other) const {
+		return _id == other._id && (_id != idNone || _key == other._key);
+	}
+
+	bool operator!=(const PyeKey& other) const {
+		return !(*this == other);
+	}
+
+	bool operator<(const PyeKey& other) const {
+		if (_id != other._id) {
+			return _id < other._id;
+		}
+		return _id == idNone && _key < other._key;
+	}
+};
+
+namespace std {
+	template<>
+	struct hash<PyeKey> {
+		size_t operator()(const PyeKey& key) const {
+			return key.isInterned() ? (size_t)key.getId() : std::hash<std::string>()(key.getKey());
+		}
+	};
+}
+
+/// <summary>
+/// Document-level dictionary of key names.
+/// Documents with many equal sub-lists (e.g. 50k sensor entries with the keys "id", "value", "unit", "ts")
+/// store every key name only once in the dictionary; the items reference the key with its 3-byte interned key.
+/// The dictionary is put to the root list after all items are put, and loaded before the items are read.
+/// Interned keys are local to a document: merge and diff of documents compare the interned keys,
+/// so both documents must be written with the same dictionary.
+/// </summary>
+class PyeKeyDictionary {
+	/// <summary> Key names by id </summary>
+	std::vector<std::string> _names;
+
+	/// <summary> Id by key name </summary>
+	std::unordered_map<std::string, unsigned __int16> _ids;
+
+public:
+	/// <summary> Maximal count of keys in the dictionary </summary>
+	static const size_t maxCount = PyeKey::idNone;
+
+	/// <summary>
+	/// Interns a key name. A new name gets the next id.
+	/// </summary>
+	/// <param name="name">key name</param>
+	/// <returns>handle of the key; a handle with the key name, if the dictionary is full</returns>
+	PyeKey intern(const std::string& name);
+
+	/// <summary>
+	/// Finds the handle of a key name without interning it.
+	/// </summary>
+	/// <param name="name">key name</param>
+	/// <param name="key">handle of the key; a handle with the key name, if the name is not in the dictionary</param>
+	/// <returns>true, if the name is in the dictionary</returns>
+	bool find(const std::string& name, PyeKey& key) const;
+
+	/// <summary>
+	/// Gets the key name of an id.
+	/// </summary>
+	/// <param name="id">id of the key</param>
+	/// <returns>key name; empty, if the id is not in the dictionary</returns>
+	const std::string& getName(unsigned __int16 id) const;
+
+	/// <summary>
+	/// Gets the key name of a key of the byte stream.
+	/// </summary>
+	/// <param name="key">interned key, escaped key name or key name</param>
+	/// <returns>key name</returns>
+	std::string getName(const std::string& key) const {
+		if (pyeIsInternedKey(key)) {
+			return getName(pyeInternedKeyId(key));
+		}
+		return PyeKey::isEscaped(key) ? key.substr(PyeKey::sizeEscape) : key;
+	}
+
+	size_t getCount() const {
+		return _names.size();
+	}
+
+	void clear() {
+		_names.clear();
+		_ids.clear();
+	}
+
+	/// <summary>
+	/// Encodes the dictionary.
+	/// </summary>
+	/// <param name="data">vector for the encoded dictionary; cleared before</param>
+	void encode(std::vector<unsigned char>& data) const;
+
+	/// <summary>
+	/// Decodes a dictionary and replaces the keys of this dictionary.
+	/// </summary>
+	/// <param name="data">pointer to the encoded dictionary</param>
+	/// <param name="size">size of the encoded dictionary</param>
+	/// <returns>false, if the encoded dictionary is not valid</returns>
+	bool decode(const unsigned char* data, size_t size);
+
+	/// <summary>
+	/// Puts the dictionary as reserved object to the root list of a document.
+	/// </summary>
+	/// <param name="rootList">root list</param>
+	void put(PyeList& rootList) const {
+		std::vector<unsigned char> data;
+		encode(data);
+		rootList.putMemory(data, Str_PYEKVSKeyDictionary);
+	}
+
+	/// <summary>
+	/// Loads the dictionary of the root list of a document.
+	/// </summary>
+	/// <param name="rootList">root list</param>
+	/// <returns>false, if the document has no valid key dictionary</returns>
+	bool load(PyeList& rootList) {
+		std::vector<unsigned char> data = rootList.getMemory(Str_PYEKVSKeyDictionary);
+		return decode(data.data(), data.size());
+	}
+};
@@ -0,0 +1,488 @@
+//#include "pch.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "pyeKVSLog.h"
+#include "pyeKVSView.h"
+#include "pyeKVSDirectory.h"
+
+
+PyeUpdate::Node* PyeUpdate::getNode(const PyeKeyPath& path) {
+	if (path.empty()) {
+		return nullptr;
+	}
+
+	Node* node = &_root;
+	for (size_t i = 0; i + 1 < path.size(); i++) {
+		if (node->puts.count(path[i]) || node->dels.count(path[i])) {
+			return nullptr;
+		}
+		node = &node->subs[path[i]];
+	}
+	return node;
+}
+
+bool PyeUpdate::putDocument(const PyeKeyPath& path, PyeDocument& document) {
+	Node* node = getNode(path);
+	if (node == nullptr) {
+		return false;
+	}
+
+	unsigned __int64 offsetObject = _values.getBuffer()->size();
+	_values.getRoot().putRawValue("v", *document.getBuffer(), 16 /*offset of the root list object*/);
+
+	setPut(*node, path.back(), offsetObject);
+	return true;
+}
+
+bool PyeUpdate::remove(const PyeKeyPath& path) {
+	Node* node = getNode(path);
+	if (node == nullptr) {
+		return false;
+	}
+
+	node->puts.erase(path.back());
+	node->subs.erase(path.back());
+	node->dels.insert(path.back());
+	return true;
+}
+
+PyeDocument PyeUpdate::encode() {
+	PyeDocument patch;
+	encodeNode(_root, patch.getRoot());
+	return patch;
+}
+
+void PyeUpdate::encodeNode(Node& node, PyeList& listPatch) {
+	if (!node.puts.empty()) {
+		std::vector<std::string> keys;
+		std::vector<std::vector<unsigned char>*> sources;
+		std::vector<unsigned __int64> offsetObjects;
+		for (const auto& item : node.puts) {
+			keys.push_back(item.first);
+			sources.push_back(_values.getBuffer());
+			offsetObjects.push_back(item.second);
+		}
+
+		PyeList listPut = listPatch.putList(Str_PYEKVSPatchPut);
+		listPut.putRawValues(keys, sources, offsetObjects);
+	}
+
+	if (!node.dels.empty()) {
+		PyeList listDel = listPatch.putList(Str_PYEKVSPatchDel);
+		for (const std::string& key : node.dels) {
+			listDel.putZero(key);
+		}
+	}
+
+	if (!node.subs.empty()) {
+		PyeList listSub = listPatch.putList(Str_PYEKVSPatchSub);
+		for (auto& item : node.subs) {
+			PyeList subPatch = listSub.putList(item.first);
+			encodeNode(item.second, subPatch);
+		}
+	}
+}
+
+/// <summary>
+/// Checks the header and the root list of an encoded pyeKVS document, before the items are decoded.
+/// </summary>
+static bool isValidDocument(const PyeByteSpan& data) {
+	unsigned __int64 sizeData;
+	unsigned __int32 sizeList;
+	return data.size() >= 26 /*header and root list*/ && memcmp(data.data(), "PYES", 4) == 0
+		&& (ReadFromVector(sizeData, data, 8), sizeData + 16 == data.size())
+		&& data[16] == 0 /*root name*/ && data[17] == pyeValueType::pyeList
+		&& (ReadFromVector(sizeList, data, 18), 26 + (unsigned __int64)sizeList == data.size());
+}
+
+bool PyeWriteAheadLog::open(const std::string& directory, PyeDocument& document, const PyeLogOptions& options) {
+	close();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_directory = directory;
+	_options = options;
+
+	unsigned __int64 sequence;
+	if (!readSnapshot(document, sequence)) {
+		return false;
+	}
+
+	// the records after the snapshot are applied; older records and a damaged tail are removed
+	unsigned __int64 sequenceLast;
+	if (!rewriteLog(sequence, &document, sequenceLast)) {
+		return false;
+	}
+
+	_file = fopen(getFilenameLog().c_str(), "ab");
+	if (_file == nullptr) {
+		return false;
+	}
+
+	_sequence = sequenceLast > sequence ? sequenceLast : sequence;
+	_sequenceWritten = _sequence;
+	_countWrites = 0;
+	_failed = false;
+	_writing = false;
+	_stopping = false;
+	_open = true;
+
+	if (_options.durability == pyeLogAsync) {
+		_writer = std::thread([this]() {
+			runWriter();
+		});
+	}
+	return true;
+}
+
+void PyeWriteAheadLog::close() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_open) {
+			return;
+		}
+		_stopping = true;
+		_condition.notify_all();
+	}
+
+	if (_writer.joinable()) {
+		_writer.join();
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_condition.wait(lock, [this]() { return !_writing; });
+	if (!_pending.empty() && !_failed) {
+		writeGroup(lock);
+	}
+
+	fclose(_file);
+	_file = nullptr;
+	_pending.clear();
+	_open = false;
+}
+
+unsigned __int64 PyeWriteAheadLog::commit(PyeDocument& patch) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_open || _failed) {
+		return 0;
+	}
+
+	unsigned __int64 sequence = ++_sequence;
+
+	PyeDocument record;
+	encodeRecord(record, sequence, *patch.getBuffer());
+	_pending.insert(_pending.end(), record.getBuffer()->begin(), record.getBuffer()->end());
+
+	if (_options.durability == pyeLogAsync) {
+		return sequence;
+	}
+
+	// the first waiting thread writes the group, the others wait for the end of its write
+	while (_sequenceWritten < sequence) {
+		if (_failed) {
+			return 0;
+		}
+		if (!_writing) {
+			writeGroup(lock);
+		}
+		else {
+			_condition.wait(lock);
+		}
+	}
+	return sequence;
+}
+
+bool PyeWriteAheadLog::sync() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_open) {
+		return false;
+	}
+
+	unsigned __int64 sequence = _sequence;
+	while (_sequenceWritten < sequence) {
+		if (_failed) {
+			return false;
+		}
+		if (!_writing) {
+			writeGroup(lock);
+		}
+		else {
+			_condition.wait(lock);
+		}
+	}
+
+	if (_options.durability == pyeLogFlush) {
+		// the written records are synced once
+		_condition.wait(lock, [this]() { return !_writing; });
+		_writing = true;
+		lock.unlock();
+		bool synced = syncFile(_file);
+		lock.lock();
+		_writing = false;
+		_condition.notify_all();
+		return synced;
+	}
+	return !_failed;
+}
+
+bool PyeWriteAheadLog::checkpoint(PyeDocument& document, unsigned __int64 sequence) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_open || _failed || sequence > _sequence) {
+		return false;
+	}
+
+	_condition.wait(lock, [this]() { return !_writing; });
+	_writing = true;
+
+	// the log holds all commits, before its records up to the snapshot are removed
+	std::vector<unsigned char> records;
+	records.swap(_pending);
+	unsigned __int64 sequenceLast = _sequence;
+	lock.unlock();
+
+	bool written = records.empty() || writeRecords(records, true);
+	bool done = written && writeSnapshot(document, sequence);
+	if (done) {
+		fclose(_file);
+
+		unsigned __int64 sequenceLog;
+		done = rewriteLog(sequence, nullptr, sequenceLog);
+
+		_file = fopen(getFilenameLog().c_str(), "ab");
+		written = _file != nullptr;
+	}
+
+	lock.lock();
+	_writing = false;
+	if (written) {
+		_sequenceWritten = sequenceLast;
+	}
+	else {
+		_failed = true;
+	}
+	_condition.notify_all();
+	return done && written;
+}
+
+bool PyeWriteAheadLog::writeGroup(std::unique_lock<std::mutex>& lock) {
+	_writing = true;
+
+	// further commits join the group during the delay
+	if (_options.delayGroup > 0 && _options.durability != pyeLogAsync) {
+		lock.unlock();
+		std::this_thread::sleep_for(std::chrono::microseconds(_options.delayGroup));
+		lock.lock();
+	}
+
+	std::vector<unsigned char> records;
+	records.swap(_pending);
+	unsigned __int64 sequence = _sequence;
+	lock.unlock();
+
+	bool written = records.empty() || writeRecords(records, _options.durability != pyeLogFlush);
+
+	lock.lock();
+	_writing = false;
+	if (written) {
+		_sequenceWritten = sequence;
+		_countWrites++;
+	}
+	else {
+		_failed = true;
+	}
+
+	// the buffer is reused by the next group
+	if (_pending.empty()) {
+		records.clear();
+		_pending.swap(records);
+	}
+
+	_condition.notify_all();
+	return written;
+}
+
+bool PyeWriteAheadLog::writeRecords(const std::vector<unsigned char>& records, bool sync) {
+	if (fwrite(records.data(), 1, records.size(), _file) != records.size() || fflush(_file) != 0) {
+		return false;
+	}
+	return !sync || syncFile(_file);
+}
+
+void PyeWriteAheadLog::runWriter() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stopping) {
+		_condition.wait_for(lock, std::chrono::milliseconds(_options.intervalAsync), [this]() { return _stopping; });
+
+		if (!_writing && !_pending.empty() && !_failed) {
+			writeGroup(lock);
+		}
+	}
+}
+
+bool PyeWriteAheadLog::readSnapshot(PyeDocument& document, unsigned __int64& sequence) {
+	document = PyeDocument();
+	sequence = 0;
+
+	std::ifstream input(getFilenameSnapshot(), std::ios::binary);
+	if (!input) {
+		// new log
+		return true;
+	}
+
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	if (!isValidDocument(PyeByteSpan(buffer))) {
+		return false;
+	}
+
+	PyeDocumentView snapshot(&buffer);
+	const PyeListView& root = snapshot.getRoot();
+
+	const unsigned char* data;
+	unsigned __int32 size;
+	if (!root.getMemoryData("d", data, size) || !isValidDocument(PyeByteSpan(data, size))) {
+		return false;
+	}
+
+	sequence = root.getUInt64("n");
+	if (root.getUInt64("h") != pyeHashKey(data, size, sequence)) {
+		return false;
+	}
+
+	document.getBuffer()->assign(data, data + size);
+	document.getRoot().decode();
+	return true;
+}
+
+bool PyeWriteAheadLog::writeSnapshot(PyeDocument& document, unsigned __int64 sequence) {
+	std::vector<unsigned char>& data = *document.getBuffer();
+
+	PyeDocument snapshot;
+	PyeList& root = snapshot.getRoot();
+	root.putUInt64(sequence, "n");
+	root.putMemory(data, "d");
+	root.putUInt64(pyeHashKey(data.data(), data.size(), sequence), "h");
+
+	// the new snapshot replaces the old one with a rename
+	std::string filename = getFilenameSnapshot();
+	std::string filenameNew = filename + ".new";
+	return writeFile(filenameNew, *snapshot.getBuffer()) && replaceFile(filenameNew, filename);
+}
+
+bool PyeWriteAheadLog::rewriteLog(unsigned __int64 sequence, PyeDocument* document, unsigned __int64& sequenceLast) {
+	sequenceLast = 0;
+
+	std::string filename = getFilenameLog();
+	std::vector<unsigned char> buffer;
+	{
+		std::ifstream input(filename, std::ios::binary);
+		if (!input) {
+			// new log
+			return true;
+		}
+		buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+
+	std::vector<unsigned char> kept;
+	unsigned __int64 offset = 0;
+	while (offset + 16 <= buffer.size()) {
+		unsigned __int64 sizeData;
+		ReadFromVector(sizeData, buffer, offset + 8);
+
+		if (memcmp(&buffer[offset], "PYES", 4) != 0 || sizeData > buffer.size() - offset - 16) {
+			break;
+		}
+
+		PyeByteSpan record(&buffer[offset], 16 + sizeData);
+		unsigned __int64 sequenceRecord;
+		PyeByteSpan patch;
+		if (!decodeRecord(record, sequenceRecord, patch)) {
+			break;
+		}
+
+		if (sequenceRecord > sequence) {
+			kept.insert(kept.end(), record.begin(), record.end());
+
+			if (document != nullptr) {
+				std::vector<unsigned char> bufferPatch(patch.begin(), patch.end());
+				PyeDocument docPatch(&bufferPatch);
+				*document = PyeDiff::patch(*document, docPatch);
+			}
+		}
+		sequenceLast = sequenceRecord;
+
+		offset += record.size();
+	}
+
+	if (kept.size() == buffer.size()) {
+		return true;
+	}
+
+	std::string filenameNew = filename + ".new";
+	return writeFile(filenameNew, kept) && replaceFile(filenameNew, filename);
+}
+
+void PyeWriteAheadLog::encodeRecord(PyeDocument& record, unsigned __int64 sequence, const std::vector<unsigned char>& patch) {
+	PyeList& root = record.getRoot();
+	root.putUInt64(sequence, "n");
+	root.putMemory(patch, "p");
+	root.putUInt64(pyeHashKey(patch.data(), patch.size(), sequence), "h");
+}
+
+bool PyeWriteAheadLog::decodeRecord(const PyeByteSpan& record, unsigned __int64& sequence, PyeByteSpan& patch) {
+	if (!isValidDocument(record)) {
+		return false;
+	}
+
+	PyeDocumentView view(record.data(), record.size());
+	const PyeListView& root = view.getRoot();
+
+	const unsigned char* data;
+	unsigned __int32 size;
+	if (!root.getMemoryData("p", data, size) || !isValidDocument(PyeByteSpan(data, size))) {
+		return false;
+	}
+
+	sequence = root.getUInt64("n");
+	if (root.getUInt64("h") != pyeHashKey(data, size, sequence)) {
+		return false;
+	}
+
+	patch = PyeByteSpan(data, size);
+	return true;
+}
+
+bool PyeWriteAheadLog::writeFile(const std::string& filename, const std::vector<unsigned char>& data) {
+	FILE* file = fopen(filename.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+
+	bool written = (data.empty() || fwrite(data.data(), 1, data.size(), file) == data.size()) && fflush(file) == 0 && syncFile(file);
+	return fclose(file) == 0 && written;
+}
+
+bool PyeWriteAheadLog::replaceFile(const std::string& filenameFrom, const std::string& filenameTo) {
+#ifdef _WIN32
+	return MoveFileExA(filenameFrom.c_str(), filenameTo.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return std::rename(filenameFrom.c_str(), filenameTo.c_str()) == 0;
+#endif
+}
+
+bool PyeWriteAheadLog::syncFile(FILE* file) {
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
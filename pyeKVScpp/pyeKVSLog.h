@@ -0,0 +1,334 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : write-ahead log of the updates of pyeKVS documents with group commit
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdio>
+#include <fstream>
+
+#include "pyeKVS.h"
+#include "pyeKVSDiff.h"
+
+#pragma once
+
+/*
+* Log directory
+* snapshot.pye		snapshot: pyeKVS document with the sequence number ("n", UInt64), the bytes of the document ("d", Memory)
+*					and the check sum ("h", UInt64)
+* log.pyelog		log: records appended one after the other
+*
+* Record: a pyeKVS document (16-byte header gives the size of the record) with the root list
+* Key	type		usage
+* n		UInt64		sequence number of the update
+* p		Memory		update: the bytes of a pyeKVS patch document (see pyeKVSDiff.h)
+* h		UInt64		check sum of the update (pyeHashKey with the sequence number as seed)
+*
+* On open the snapshot is loaded and the records with a higher sequence number are applied in the order of the log.
+* The scan stops at the first incomplete or damaged record (e.g. a write cut off by a crash).
+*/
+
+/// <summary>
+/// Path of an object in a document: the keys of the sub-lists and the key of the object.
+/// </summary>
+typedef std::vector<std::string> PyeKeyPath;
+
+/// <summary>
+/// Update of a pyeKVS document: puts and deletes of objects by path.
+/// The update is encoded as pyeKVS patch (see PyeDiff), so it is written to a log and applied with PyeDiff::patch.
+/// A later operation on the same path replaces an earlier one.
+/// The lists of a path must exist in the document; a new sub-list is put as a whole with putDocument.
+/// </summary>
+class PyeUpdate {
+public:
+	PyeUpdate() {}
+
+	/// <summary>
+	/// Puts (adds or replaces) the value of an object.
+	/// </summary>
+	/// <typeparam name="V">C++ type of the value with a PyeValueTypeTraits specialization</typeparam>
+	/// <param name="path">path of the object</param>
+	/// <param name="value">value</param>
+	/// <returns>false, if the path is empty or leads through an object, which is put or deleted by this update</returns>
+	template<class V>
+	bool put(const PyeKeyPath& path, const V& value) {
+		Node* node = getNode(path);
+		if (node == nullptr) {
+			return false;
+		}
+
+		unsigned __int64 offsetObject = _values.getBuffer()->size();
+		_values.getRoot().put(value, "v");
+
+		setPut(*node, path.back(), offsetObject);
+		return true;
+	}
+
+	/// <summary>
+	/// Puts (adds or replaces) an object with the root list of a document as sub-list.
+	/// </summary>
+	/// <param name="path">path of the object</param>
+	/// <param name="document">pyeKVS document</param>
+	/// <returns>false, if the path is empty or leads through an object, which is put or deleted by this update</returns>
+	bool putDocument(const PyeKeyPath& path, PyeDocument& document);
+
+	/// <summary>
+	/// Deletes an object.
+	/// </summary>
+	/// <param name="path">path of the object</param>
+	/// <returns>false, if the path is empty or leads through an object, which is put or deleted by this update</returns>
+	bool remove(const PyeKeyPath& path);
+
+	bool isEmpty() const {
+		return _root.puts.empty() && _root.dels.empty() && _root.subs.empty();
+	}
+
+	/// <summary>
+	/// Removes all operations.
+	/// </summary>
+	void clear() {
+		_root = Node();
+		_values.reset();
+	}
+
+	/// <summary>
+	/// Encodes the update as pyeKVS patch.
+	/// </summary>
+	/// <returns>pyeKVS document with the patch</returns>
+	PyeDocument encode();
+
+	/// <summary>
+	/// Applies the update to a document.
+	/// </summary>
+	/// <param name="document">pyeKVS document</param>
+	/// <returns>new pyeKVS document</returns>
+	PyeDocument apply(PyeDocument& document) {
+		PyeDocument patch = encode();
+		return PyeDiff::patch(document, patch);
+	}
+
+private:
+	/// <summary> Operations on the objects of one list </summary>
+	struct Node {
+		std::map<std::string, unsigned __int64> puts;	// offset of the encoded object in _values
+		std::set<std::string> dels;
+		std::map<std::string, Node> subs;
+	};
+
+	Node _root;
+
+	/// <summary> Encoded values of the puts </summary>
+	PyeDocument _values;
+
+	/// <summary>
+	/// Gets the node of the list of the last key of a path.
+	/// </summary>
+	Node* getNode(const PyeKeyPath& path);
+
+	static void setPut(Node& node, const std::string& key, unsigned __int64 offsetObject) {
+		node.dels.erase(key);
+		node.subs.erase(key);
+		node.puts[key] = offsetObject;
+	}
+
+	void encodeNode(Node& node, PyeList& listPatch);
+};
+
+/// <summary>
+/// Enum of the durability of the commits of a write-ahead log.
+/// </summary>
+enum pyeLogDurability : unsigned __int8 {
+	pyeLogSync,		// commit returns after the record is synced to the disk (fsync); safe on power loss
+	pyeLogFlush,	// commit returns after the record is written to the operating system; safe on a crash of the process
+	pyeLogAsync		// commit returns at once; a background thread writes and syncs the records in intervals
+};
+
+/// <summary>
+/// Options of a PyeWriteAheadLog
+/// </summary>
+struct PyeLogOptions {
+	/// <summary> Durability of the commits </summary>
+	pyeLogDurability durability = pyeLogSync;
+
+	/// <summary> Time in microseconds, which the writer of a group waits for further commits; more latency, fewer syncs </summary>
+	unsigned __int32 delayGroup = 0;
+
+	/// <summary> Interval in milliseconds of the background writes with pyeLogAsync </summary>
+	unsigned __int32 intervalAsync = 10;
+};
+
+/// <summary>
+/// Write-ahead log of the updates of a long-lived pyeKVS document.
+/// Every update is appended as record to the log before (or while) it is applied to the document in memory.
+/// Commits of several threads are written together with one write and one sync (group commit):
+/// the first waiting thread writes the records of all waiting threads, the others wait for its sync.
+/// A checkpoint writes a snapshot of the document and removes the older records from the log.
+/// On open the snapshot is loaded and the later records are replayed.
+/// </summary>
+class PyeWriteAheadLog {
+public:
+	PyeWriteAheadLog() {}
+	~PyeWriteAheadLog() {
+		close();
+	}
+
+	PyeWriteAheadLog(const PyeWriteAheadLog&) = delete;
+	PyeWriteAheadLog& operator=(const PyeWriteAheadLog&) = delete;
+
+	/// <summary>
+	/// Opens the log in an existing directory, loads the snapshot and replays the records of the log.
+	/// A damaged tail of the log is removed.
+	/// </summary>
+	/// <param name="directory">directory of the log</param>
+	/// <param name="document">gets the recovered document; an empty document, if the directory is new</param>
+	/// <param name="options">options</param>
+	/// <returns>false, if the snapshot is damaged or a file cannot be read or written</returns>
+	bool open(const std::string& directory, PyeDocument& document, const PyeLogOptions& options = PyeLogOptions());
+
+	/// <summary>
+	/// Writes the records of all commits and closes the log.
+	/// </summary>
+	void close();
+
+	/// <summary>
+	/// Appends an update to the log. The durability of the options gives, when the call returns.
+	/// </summary>
+	/// <param name="update">update</param>
+	/// <returns>sequence number of the update; 0, if the log is not open or a write failed</returns>
+	unsigned __int64 commit(PyeUpdate& update) {
+		PyeDocument patch = update.encode();
+		return commit(patch);
+	}
+
+	/// <summary>
+	/// Appends a pyeKVS patch (see PyeDiff::diff) to the log. The durability of the options gives, when the call returns.
+	/// </summary>
+	/// <param name="patch">pyeKVS patch document</param>
+	/// <returns>sequence number of the update; 0, if the log is not open or a write failed</returns>
+	unsigned __int64 commit(PyeDocument& patch);
+
+	/// <summary>
+	/// Writes and syncs the records of all commits.
+	/// </summary>
+	/// <returns>false, if a write failed</returns>
+	bool sync();
+
+	/// <summary>
+	/// Writes a snapshot of the document and removes the records up to the sequence number from the log.
+	/// </summary>
+	/// <param name="document">pyeKVS document with all updates up to the sequence number</param>
+	/// <param name="sequence">sequence number of the last update of the document</param>
+	/// <returns>false, if the snapshot or the log cannot be written</returns>
+	bool checkpoint(PyeDocument& document, unsigned __int64 sequence);
+
+	/// <summary>
+	/// Gets the sequence number of the last commit.
+	/// </summary>
+	unsigned __int64 getSequence() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _sequence;
+	}
+
+	/// <summary>
+	/// Gets the sequence number of the last written commit (synced with pyeLogSync).
+	/// </summary>
+	unsigned __int64 getSequenceWritten() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _sequenceWritten;
+	}
+
+	/// <summary>
+	/// Gets the count of writes of groups of records; less than the count of commits, if commits were grouped.
+	/// </summary>
+	unsigned __int64 getCountWrites() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _countWrites;
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _condition;
+
+	std::string _directory;
+	PyeLogOptions _options;
+	bool _open = false;
+	bool _failed = false;
+
+	FILE* _file = nullptr;
+
+	/// <summary> Records of the commits, which are not written </summary>
+	std::vector<unsigned char> _pending;
+
+	unsigned __int64 _sequence = 0;
+	unsigned __int64 _sequenceWritten = 0;
+	unsigned __int64 _countWrites = 0;
+
+	/// <summary> A thread writes to the file </summary>
+	bool _writing = false;
+
+	std::thread _writer;
+	bool _stopping = false;
+
+	std::string getFilenameLog() const {
+		return _directory + "/log.pyelog";
+	}
+
+	std::string getFilenameSnapshot() const {
+		return _directory + "/snapshot.pye";
+	}
+
+	/// <summary>
+	/// Writes the pending records as one group; the caller holds the lock and no other thread writes.
+	/// The lock is released during the write.
+	/// </summary>
+	bool writeGroup(std::unique_lock<std::mutex>& lock);
+
+	/// <summary>
+	/// Writes records to the log file; the caller is the only writer.
+	/// </summary>
+	bool writeRecords(const std::vector<unsigned char>& records, bool sync);
+
+	/// <summary>
+	/// Background writer of pyeLogAsync.
+	/// </summary>
+	void runWriter();
+
+	bool readSnapshot(PyeDocument& document, unsigned __int64& sequence);
+	bool writeSnapshot(PyeDocument& document, unsigned __int64 sequence);
+
+	/// <summary>
+	/// Rewrites the log with the valid records after the sequence number.
+	/// </summary>
+	/// <param name="sequence">sequence number; the records up to this number are removed</param>
+	/// <param name="document">the kept records are applied to the document, if not null</param>
+	/// <param name="sequenceLast">gets the sequence number of the last valid record</param>
+	bool rewriteLog(unsigned __int64 sequence, PyeDocument* document, unsigned __int64& sequenceLast);
+
+	static void encodeRecord(PyeDocument& record, unsigned __int64 sequence, const std::vector<unsigned char>& patch);
+	static bool decodeRecord(const PyeByteSpan& record, unsigned __int64& sequence, PyeByteSpan& patch);
+
+	/// <summary>
+	/// Writes a file and syncs it to the disk.
+	/// </summary>
+	static bool writeFile(const std::string& filename, const std::vector<unsigned char>& data);
+
+	/// <summary>
+	/// Replaces a file by another one with a rename.
+	/// </summary>
+	static bool replaceFile(const std::string& filenameFrom, const std::string& filenameTo);
+
+	static bool syncFile(FILE* file);
+};
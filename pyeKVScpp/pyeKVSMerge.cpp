@@ -0,0 +1,87 @@
+//#include "pch.h"
+
+#include <vector>
+#include <map>
+
+#include "pyeKVSMerge.h"
+
+
+PyeDocument PyeMerge::merge(PyeDocument& docTarget, PyeDocument& docSource, pyeMergePolicy policy, bool mergeLists) {
+	PyeDocument docResult;
+
+	mergeList(docTarget.getRoot(), docSource.getRoot(), docResult.getRoot(), policy, mergeLists);
+
+	return docResult;
+}
+
+void PyeMerge::mergeList(PyeList& listTarget, PyeList& listSource, PyeList& listResult, pyeMergePolicy policy, bool mergeLists) {
+	std::vector<unsigned char>& bufferTarget = *listTarget.getBuffer();
+	std::vector<unsigned char>& bufferSource = *listSource.getBuffer();
+	const PyeItemIdx& idxTarget = listTarget.getItemIdx();
+	const PyeItemIdx& idxSource = listSource.getItemIdx();
+
+	// objects of the same byte stream are collected and copied in one step
+	std::vector<unsigned __int64> pending;
+	std::vector<unsigned char>* pendingBuffer = &bufferTarget;
+
+	auto flush = [&]() {
+		if (!pending.empty()) {
+			listResult.putRaw(*pendingBuffer, pending);
+			pending.clear();
+		}
+	};
+
+	auto add = [&](std::vector<unsigned char>& buffer, unsigned __int64 offsetObject) {
+		if (pendingBuffer != &buffer) {
+			flush();
+			pendingBuffer = &buffer;
+		}
+		pending.push_back(offsetObject);
+	};
+
+	for (unsigned __int64 offsetObject : listTarget.getItemOffsets()) {
+		unsigned __int8 keySize = bufferTarget[offsetObject];
+		std::string key(&bufferTarget[offsetObject + 1], &bufferTarget[offsetObject + 1] + keySize);
+
+		// reserved objects describe their own list and are not valid in the result
+		if (pyeIsReservedKey(key)) {
+			continue;
+		}
+
+		auto itemSource = idxSource.find(key);
+		if (itemSource == idxSource.end()) {
+			add(bufferTarget, offsetObject);
+			continue;
+		}
+
+		unsigned __int8 typeTarget = bufferTarget[offsetObject + 1 /*information key size*/ + keySize];
+		unsigned __int8 typeSource = bufferSource[itemSource->second + 1 /*information key size*/ + keySize];
+
+		if (mergeLists && typeTarget == pyeValueType::pyeList && typeSource == pyeValueType::pyeList) {
+			flush();
+
+			PyeList subTarget = listTarget.getList(key);
+			PyeList subSource = listSource.getList(key);
+			PyeList subResult = listResult.putList(key);
+			mergeList(subTarget, subSource, subResult, policy, mergeLists);
+		}
+		else if (policy == pyeMergeKeepTarget) {
+			add(bufferTarget, offsetObject);
+		}
+		else {
+			add(bufferSource, itemSource->second);
+		}
+	}
+
+	// objects only in the source list
+	for (unsigned __int64 offsetObject : listSource.getItemOffsets()) {
+		unsigned __int8 keySize = bufferSource[offsetObject];
+		std::string key(&bufferSource[offsetObject + 1], &bufferSource[offsetObject + 1] + keySize);
+
+		if (idxTarget.find(key) == idxTarget.end() && !pyeIsReservedKey(key)) {
+			add(bufferSource, offsetObject);
+		}
+	}
+
+	flush();
+}
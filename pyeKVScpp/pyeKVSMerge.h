@@ -0,0 +1,56 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : structural merge of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/// <summary>
+/// Enum of the policies to resolve a key which exists in both lists of a merge.
+/// </summary>
+enum pyeMergePolicy : unsigned __int8 {
+	pyeMergeKeepTarget,		// the value of the target list is used
+	pyeMergeTakeSource		// the value of the source list is used
+};
+
+/// <summary>
+/// Merges the items of a source list into a target list.
+/// The pyeKVS objects are copied as encoded bytes, the values are not decoded.
+/// The headers of the result lists are updated once per copied block of objects.
+/// </summary>
+class PyeMerge {
+public:
+	/// <summary>
+	/// Merges two pyeKVS documents into a new pyeKVS document.
+	/// </summary>
+	/// <param name="docTarget">pyeKVS document with the base data</param>
+	/// <param name="docSource">pyeKVS document with the data to merge into the target</param>
+	/// <param name="policy">policy for keys in both documents</param>
+	/// <param name="mergeLists">true: sub-lists with the same key are merged recursively</param>
+	/// <returns>merged pyeKVS document</returns>
+	static PyeDocument merge(PyeDocument& docTarget, PyeDocument& docSource, pyeMergePolicy policy = pyeMergeTakeSource, bool mergeLists = true);
+
+	/// <summary>
+	/// Merges two pyeKVS lists into a result list.
+	/// The objects of the target list are written first in their order, then the new objects of the source list.
+	/// </summary>
+	/// <param name="listTarget">list with the base data</param>
+	/// <param name="listSource">list with the data to merge into the target</param>
+	/// <param name="listResult">new and empty list for the result</param>
+	/// <param name="policy">policy for keys in both lists</param>
+	/// <param name="mergeLists">true: sub-lists with the same key are merged recursively</param>
+	static void mergeList(PyeList& listTarget, PyeList& listSource, PyeList& listResult, pyeMergePolicy policy = pyeMergeTakeSource, bool mergeLists = true);
+};
@@ -0,0 +1,313 @@
+//#include "pch.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "pyeKVSNumeric.h"
+
+
+/// <summary>
+/// Count of leading zero bits; value must not be 0.
+/// </summary>
+static inline unsigned int pyeLeadingZeros(unsigned __int64 value) {
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanReverse64(&idx, value);
+	return 63 - idx;
+#else
+	return __builtin_clzll(value);
+#endif
+}
+
+/// <summary>
+/// Count of trailing zero bits; value must not be 0.
+/// </summary>
+static inline unsigned int pyeTrailingZeros(unsigned __int64 value) {
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward64(&idx, value);
+	return idx;
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+/// <summary>
+/// Count of bits of a value.
+/// </summary>
+static inline unsigned int pyeBitWidth(unsigned __int64 value) {
+	return value == 0 ? 0 : 64 - pyeLeadingZeros(value);
+}
+
+/// <summary>
+/// Appends bits to a bit stream; the bits of a byte are filled from the lowest bit.
+/// </summary>
+class PyeBitWriter {
+	std::vector<unsigned char>& _stream;
+	unsigned __int64 _bits = 0;
+	unsigned int _count = 0;
+
+public:
+	PyeBitWriter(std::vector<unsigned char>& stream) : _stream(stream) {}
+
+	void write(unsigned __int64 value, unsigned int width) {
+		if (width == 0) {
+			return;
+		}
+		if (width < 64) {
+			value &= (1ULL << width) - 1;
+		}
+
+		_bits |= value << _count;
+		if (_count + width >= 64) {
+			WriteToVector(_stream, _bits, _stream.size());
+			unsigned int written = 64 - _count;
+			_bits = written < 64 ? value >> written : 0;
+			_count = _count + width - 64;
+		}
+		else {
+			_count += width;
+		}
+	}
+
+	void flush() {
+		while (_count > 0) {
+			_stream.push_back((unsigned char)_bits);
+			_bits >>= 8;
+			_count = _count > 8 ? _count - 8 : 0;
+		}
+	}
+};
+
+/// <summary>
+/// Reads bits of a bit stream with 8 bytes of padding at the end.
+/// </summary>
+static inline unsigned __int64 pyeReadBits(const unsigned char* data, unsigned __int64 pos, unsigned int width) {
+	if (width == 0) {
+		return 0;
+	}
+
+	unsigned __int64 word;
+	memcpy(&word, &data[pos >> 3], sizeof(word));
+
+	unsigned int shift = (unsigned int)(pos & 7);
+	unsigned __int64 value = word >> shift;
+	if (shift + width > 64) {
+		value |= (unsigned __int64)data[(pos >> 3) + 8] << (64 - shift);
+	}
+
+	return width == 64 ? value : value & ((1ULL << width) - 1);
+}
+
+/// <summary>
+/// Unpacks values of a fixed bit width of a bit stream with 8 bytes of padding at the end and adds the minimum.
+/// The width is checked once for all values, the loops have no branches.
+/// </summary>
+static inline void pyeUnpackBits(const unsigned char* data, unsigned int width, unsigned __int64 minimum, unsigned __int64* values, size_t count) {
+	if (width == 0) {
+		std::fill(values, values + count, minimum);
+		return;
+	}
+
+	unsigned __int64 mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+	unsigned __int64 pos = 0;
+	if (width <= 57) {
+		// shift (max 7 bits) and width fit in one word
+		for (size_t i = 0; i < count; i++, pos += width) {
+			unsigned __int64 word;
+			memcpy(&word, &data[pos >> 3], sizeof(word));
+			values[i] = minimum + ((word >> (pos & 7)) & mask);
+		}
+	}
+	else {
+		// the high bits are in the byte after the word; shifted in two steps, so a shift of 0 adds nothing
+		for (size_t i = 0; i < count; i++, pos += width) {
+			unsigned __int64 word;
+			memcpy(&word, &data[pos >> 3], sizeof(word));
+			unsigned int shift = (unsigned int)(pos & 7);
+			unsigned __int64 high = data[(pos >> 3) + 8];
+			values[i] = minimum + (((word >> shift) | ((high << 1) << (63 - shift))) & mask);
+		}
+	}
+}
+
+void PyeNumericArray::writeHeader(std::vector<unsigned char>& stream, pyeNumericEncoding encoding, pyeValueType valueType, size_t count) {
+	stream.clear();
+
+	unsigned __int8 encodingId = encoding;
+	WriteToVector(stream, encodingId, stream.size());
+
+	unsigned __int8 valueTypeId = valueType;
+	WriteToVector(stream, valueTypeId, stream.size());
+
+	unsigned __int32 count32 = (unsigned __int32)count;
+	WriteToVector(stream, count32, stream.size());
+}
+
+bool PyeNumericArray::readHeader(const unsigned char* stream, size_t size, pyeNumericEncoding encoding, pyeValueType valueType, unsigned __int32& count) {
+	if (size < sizeHeader + 8 /*padding*/ || stream[0] != encoding || stream[1] != valueType) {
+		return false;
+	}
+	memcpy(&count, &stream[2], sizeof(count));
+	return true;
+}
+
+void PyeNumericArray::writeBlock(std::vector<unsigned char>& stream, const unsigned __int64* deltas, size_t count) {
+	unsigned __int64 minimum = *std::min_element(deltas, deltas + count, [](unsigned __int64 a, unsigned __int64 b) {
+		return (__int64)a < (__int64)b;
+	});
+
+	unsigned __int64 maximum = 0;
+	for (size_t i = 0; i < count; i++) {
+		maximum = std::max(maximum, deltas[i] - minimum);
+	}
+	unsigned __int8 width = (unsigned __int8)pyeBitWidth(maximum);
+
+	WriteToVector(stream, minimum, stream.size());
+	WriteToVector(stream, width, stream.size());
+
+	PyeBitWriter writer(stream);
+	for (size_t i = 0; i < count; i++) {
+		writer.write(deltas[i] - minimum, width);
+	}
+	writer.flush();
+}
+
+bool PyeNumericArray::readBlock(const unsigned char* stream, size_t size, size_t& pos, unsigned __int64* deltas, size_t count) {
+	if (pos + 9 > size - 8 /*padding*/) {
+		return false;
+	}
+
+	unsigned __int64 minimum;
+	memcpy(&minimum, &stream[pos], sizeof(minimum));
+	unsigned int width = stream[pos + 8];
+	pos += 9;
+
+	size_t sizePacked = (count * width + 7) / 8;
+	if (width > 64 || pos + sizePacked > size - 8 /*padding*/) {
+		return false;
+	}
+
+	pyeUnpackBits(&stream[pos], width, minimum, deltas, count);
+	pos += sizePacked;
+
+	return true;
+}
+
+void PyeNumericArray::encode(const double* values, size_t count, std::vector<unsigned char>& stream) {
+	writeHeader(stream, pyeNumericXorFloat, pyeValueType::pyeFloat64, count);
+
+	PyeBitWriter writer(stream);
+	unsigned __int64 previous = 0;
+	unsigned int leadingPrevious = 65;	// no window
+	unsigned int trailingPrevious = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		unsigned __int64 value;
+		memcpy(&value, &values[i], sizeof(value));
+
+		if (i == 0) {
+			writer.write(value, 64);
+			previous = value;
+			continue;
+		}
+
+		unsigned __int64 xorValue = value ^ previous;
+		previous = value;
+
+		if (xorValue == 0) {
+			writer.write(0, 1);
+			continue;
+		}
+
+		unsigned int leading = std::min(pyeLeadingZeros(xorValue), 31u);
+		unsigned int trailing = pyeTrailingZeros(xorValue);
+
+		if (leadingPrevious <= 64 && leading >= leadingPrevious && trailing >= trailingPrevious) {
+			// meaningful bits in the window of the previous value
+			writer.write(1, 1);
+			writer.write(0, 1);
+			writer.write(xorValue >> trailingPrevious, 64 - leadingPrevious - trailingPrevious);
+		}
+		else {
+			unsigned int length = 64 - leading - trailing;
+			writer.write(1, 1);
+			writer.write(1, 1);
+			writer.write(leading, 5);
+			writer.write(length - 1, 6);
+			writer.write(xorValue >> trailing, length);
+
+			leadingPrevious = leading;
+			trailingPrevious = trailing;
+		}
+	}
+
+	writer.flush();
+	stream.resize(stream.size() + 8 /*padding*/, 0);
+}
+
+bool PyeNumericArray::decode(const unsigned char* stream, size_t size, std::vector<double>& values) {
+	values.clear();
+
+	unsigned __int32 count;
+	if (!readHeader(stream, size, pyeNumericXorFloat, pyeValueType::pyeFloat64, count)) {
+		return false;
+	}
+	if (count == 0) {
+		return true;
+	}
+
+	const unsigned char* bits = &stream[sizeHeader];
+	unsigned __int64 sizeBits = (unsigned __int64)(size - sizeHeader - 8 /*padding*/) * 8;
+	unsigned __int64 pos = 0;
+
+	// every value needs at least 1 bit, the first value 64 bits
+	if (sizeBits < 64 || sizeBits - 64 < count - 1ULL) {
+		return false;
+	}
+
+	values.resize(count);
+
+	unsigned __int64 value = pyeReadBits(bits, pos, 64);
+	pos += 64;
+	memcpy(&values[0], &value, sizeof(value));
+
+	unsigned int leading = 0;
+	unsigned int trailing = 0;
+
+	for (unsigned __int32 i = 1; i < count; i++) {
+		if (pos + 13 > sizeBits + 64 /*padding*/) {
+			values.clear();
+			return false;
+		}
+
+		if (pyeReadBits(bits, pos++, 1) != 0) {
+			if (pyeReadBits(bits, pos++, 1) != 0) {
+				leading = (unsigned int)pyeReadBits(bits, pos, 5);
+				unsigned int length = (unsigned int)pyeReadBits(bits, pos + 5, 6) + 1;
+				pos += 11;
+				if (leading + length > 64) {
+					values.clear();
+					return false;
+				}
+				trailing = 64 - leading - length;
+			}
+
+			unsigned int length = 64 - leading - trailing;
+			if (pos + length > sizeBits) {
+				values.clear();
+				return false;
+			}
+			value ^= pyeReadBits(bits, pos, length) << trailing;
+			pos += length;
+		}
+
+		memcpy(&values[i], &value, sizeof(value));
+	}
+
+	return true;
+}
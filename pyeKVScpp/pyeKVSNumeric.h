@@ -0,0 +1,208 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : lightweight encodings of integer and float arrays
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <cstring>
+#include <algorithm>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Encoded array (stored as pyeMemory)
+* Name			type			size in byte	usage
+* Encoding		UInt8			1				pyeNumericEncoding
+* ValueType		pyeValueType	1				pye value type of the values
+* Count			UInt32			4				count of values
+* Data			bytes							encoded values
+* Padding		bytes			8				zero bytes; the decoder reads whole 64 bit words
+*
+* pyeNumericDeltaBitPacked (integers)
+* First			UInt64			8				first value
+* Block0		Min UInt64		8				minimum of the deltas of the block (frame of reference)
+*				Width UInt8		1				bits per delta
+*				Deltas			16*Width		128 deltas - Min with Width bits; the last block can be shorter
+* Block1		...
+*
+* pyeNumericXorFloat (doubles)
+* Bit stream of the XOR of every value with the previous value: 0 = same value;
+* 10 = meaningful bits in the window of the previous value; 11 = 5 bits leading zeros, 6 bits length - 1 and the meaningful bits.
+*/
+
+/// <summary>
+/// Encodings of numeric arrays
+/// </summary>
+enum pyeNumericEncoding : unsigned __int8 {
+	pyeNumericUnknown,
+	pyeNumericDeltaBitPacked,	// integers: delta to the previous value, bit-packed in blocks with frame of reference
+	pyeNumericXorFloat			// doubles: XOR with the previous value, only the meaningful bits
+};
+
+/// <summary>
+/// Lightweight encodings for arrays of time series, e.g. monotone timestamps and slowly changing sensor values.
+/// Integers are stored as deltas, bit-packed with a fixed width in blocks of 128 values,
+/// so the decoder runs a loop without branches per block. Constant steps need 0 bits per value.
+/// Doubles are stored as XOR with the previous value (Gorilla method); equal values need 1 bit.
+/// </summary>
+class PyeNumericArray {
+public:
+	/// <summary> Count of values in a bit-packed block </summary>
+	static const size_t sizeBlock = 128;
+
+	/// <summary>
+	/// Encodes integers with delta and bit-packing.
+	/// </summary>
+	/// <typeparam name="T">C++ integer type</typeparam>
+	/// <param name="values">pointer to the values</param>
+	/// <param name="count">count of values</param>
+	/// <param name="stream">vector for the encoded array; cleared before</param>
+	template<class T>
+	static void encode(const T* values, size_t count, std::vector<unsigned char>& stream) {
+		static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "integer type or double expected");
+
+		const pyeValueType valueType = PyeValueTypeTraits<T>::valueType;
+		writeHeader(stream, pyeNumericDeltaBitPacked, valueType, count);
+
+		if (count > 0) {
+			unsigned __int64 first = (unsigned __int64)(__int64)values[0];
+			WriteToVector(stream, first, stream.size());
+		}
+
+		unsigned __int64 deltas[sizeBlock];
+		for (size_t start = 1; start < count; start += sizeBlock) {
+			size_t countBlock = count - start < sizeBlock ? count - start : sizeBlock;
+			for (size_t i = 0; i < countBlock; i++) {
+				deltas[i] = (unsigned __int64)(__int64)values[start + i] - (unsigned __int64)(__int64)values[start + i - 1];
+			}
+			writeBlock(stream, deltas, countBlock);
+		}
+
+		stream.resize(stream.size() + 8 /*padding*/, 0);
+	}
+
+	/// <summary>
+	/// Encodes doubles with XOR to the previous value.
+	/// </summary>
+	/// <param name="values">pointer to the values</param>
+	/// <param name="count">count of values</param>
+	/// <param name="stream">vector for the encoded array; cleared before</param>
+	static void encode(const double* values, size_t count, std::vector<unsigned char>& stream);
+
+	/// <summary>
+	/// Decodes integers.
+	/// </summary>
+	/// <typeparam name="T">C++ integer type; must match the pye value type of the encoded values</typeparam>
+	/// <param name="stream">pointer to the encoded array</param>
+	/// <param name="size">size of the encoded array</param>
+	/// <param name="values">vector for the values; cleared before</param>
+	/// <returns>false, if the encoded array is not valid or has another type</returns>
+	template<class T>
+	static bool decode(const unsigned char* stream, size_t size, std::vector<T>& values) {
+		static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "integer type or double expected");
+
+		values.clear();
+
+		unsigned __int32 count;
+		if (!readHeader(stream, size, pyeNumericDeltaBitPacked, PyeValueTypeTraits<T>::valueType, count)) {
+			return false;
+		}
+		if (count == 0) {
+			return true;
+		}
+
+		size_t pos = sizeHeader;
+		if (pos + 8 > size - 8 /*padding*/) {
+			return false;
+		}
+
+		unsigned __int64 value;
+		memcpy(&value, &stream[pos], sizeof(value));
+		pos += 8;
+
+		values.resize(count);
+		values[0] = (T)value;
+
+		unsigned __int64 deltas[sizeBlock];
+		for (size_t start = 1; start < count; start += sizeBlock) {
+			size_t countBlock = count - start < sizeBlock ? count - start : sizeBlock;
+			if (!readBlock(stream, size, pos, deltas, countBlock)) {
+				values.clear();
+				return false;
+			}
+
+			for (size_t i = 0; i < countBlock; i++) {
+				value += deltas[i];
+				values[start + i] = (T)value;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Decodes doubles.
+	/// </summary>
+	/// <param name="stream">pointer to the encoded array</param>
+	/// <param name="size">size of the encoded array</param>
+	/// <param name="values">vector for the values; cleared before</param>
+	/// <returns>false, if the encoded array is not valid or has another type</returns>
+	static bool decode(const unsigned char* stream, size_t size, std::vector<double>& values);
+
+	/// <summary>
+	/// Puts an encoded array as pyeMemory to a list.
+	/// </summary>
+	/// <typeparam name="T">C++ integer type or double</typeparam>
+	/// <param name="list">pyeList</param>
+	/// <param name="key">key name</param>
+	/// <param name="values">values</param>
+	template<class T>
+	static void put(PyeList& list, const std::string& key, const std::vector<T>& values) {
+		std::vector<unsigned char> stream;
+		encode(values.data(), values.size(), stream);
+		list.putMemory(stream, key);
+	}
+
+	/// <summary>
+	/// Gets an encoded array of a list.
+	/// </summary>
+	/// <typeparam name="T">C++ integer type or double</typeparam>
+	/// <param name="list">pyeList</param>
+	/// <param name="key">key name</param>
+	/// <param name="values">vector for the values; cleared before</param>
+	/// <returns>false, if the key does not exist or is no encoded array of T</returns>
+	template<class T>
+	static bool get(PyeList& list, const std::string& key, std::vector<T>& values) {
+		std::vector<unsigned char> stream = list.getMemory(key);
+		return decode(stream.data(), stream.size(), values);
+	}
+
+private:
+	/// <summary> Size of the header: encoding, value type and count </summary>
+	static const size_t sizeHeader = 6;
+
+	static void writeHeader(std::vector<unsigned char>& stream, pyeNumericEncoding encoding, pyeValueType valueType, size_t count);
+
+	static bool readHeader(const unsigned char* stream, size_t size, pyeNumericEncoding encoding, pyeValueType valueType, unsigned __int32& count);
+
+	/// <summary>
+	/// Writes a block of deltas with frame of reference and bit-packing.
+	/// </summary>
+	static void writeBlock(std::vector<unsigned char>& stream, const unsigned __int64* deltas, size_t count);
+
+	/// <summary>
+	/// Reads a block of deltas.
+	/// </summary>
+	static bool readBlock(const unsigned char* stream, size_t size, size_t& pos, unsigned __int64* deltas, size_t count);
+};
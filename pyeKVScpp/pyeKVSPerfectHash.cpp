@@ -0,0 +1,253 @@
+//#include "pch.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "pyeKVSPerfectHash.h"
+
+
+bool PyePerfectHash::build(const std::vector<unsigned __int64>& hashes, unsigned __int32 countBuckets, unsigned __int32 countSlots,
+	std::vector<unsigned __int16>& pilots, std::vector<unsigned __int32>& slots) {
+	unsigned __int32 count = (unsigned __int32)hashes.size();
+
+	// keys sorted by bucket (counting sort)
+	std::vector<unsigned __int32> bucketStart(countBuckets + 1, 0);
+	for (unsigned __int64 hash : hashes) {
+		bucketStart[hash % countBuckets + 1]++;
+	}
+	for (unsigned __int32 i = 0; i < countBuckets; i++) {
+		bucketStart[i + 1] += bucketStart[i];
+	}
+
+	std::vector<unsigned __int32> keysOfBuckets(count);
+	std::vector<unsigned __int32> fill(bucketStart.begin(), bucketStart.end() - 1);
+	for (unsigned __int32 i = 0; i < count; i++) {
+		keysOfBuckets[fill[hashes[i] % countBuckets]++] = i;
+	}
+
+	// largest buckets first
+	std::vector<unsigned __int32> buckets(countBuckets);
+	for (unsigned __int32 i = 0; i < countBuckets; i++) {
+		buckets[i] = i;
+	}
+	std::stable_sort(buckets.begin(), buckets.end(), [&](unsigned __int32 a, unsigned __int32 b) {
+		return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+	});
+
+	pilots.assign(countBuckets, 0);
+	slots.assign(count, 0);
+	std::vector<bool> taken(countSlots, false);
+	std::vector<unsigned __int64> slotsOfBucket;
+
+	for (unsigned __int32 bucket : buckets) {
+		unsigned __int32 first = bucketStart[bucket];
+		unsigned __int32 last = bucketStart[bucket + 1];
+		if (first == last) {
+			break;
+		}
+
+		bool placed = false;
+		for (unsigned __int32 pilot = 0; pilot <= 0xFFFF && !placed; pilot++) {
+			slotsOfBucket.clear();
+			placed = true;
+
+			for (unsigned __int32 i = first; i < last; i++) {
+				unsigned __int64 slot = getSlot(hashes[keysOfBuckets[i]], (unsigned __int16)pilot, countSlots);
+				if (taken[slot] || std::find(slotsOfBucket.begin(), slotsOfBucket.end(), slot) != slotsOfBucket.end()) {
+					placed = false;
+					break;
+				}
+				slotsOfBucket.push_back(slot);
+			}
+
+			if (placed) {
+				pilots[bucket] = (unsigned __int16)pilot;
+				for (unsigned __int32 i = first; i < last; i++) {
+					taken[slotsOfBucket[i - first]] = true;
+					slots[keysOfBuckets[i]] = (unsigned __int32)slotsOfBucket[i - first];
+				}
+			}
+		}
+
+		if (!placed) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool PyePerfectHash::put(PyeList& list) {
+	std::vector<std::string> keys;
+	std::vector<unsigned __int32> offsets;
+	for (const auto& item : list.getItemIdx()) {
+		if (pyeIsReservedKey(item.first)) {
+			continue;
+		}
+		keys.push_back(item.first);
+		offsets.push_back((unsigned __int32)(item.second - list.getOffsetObject()));
+	}
+
+	unsigned __int32 count = (unsigned __int32)keys.size();
+	unsigned __int32 countBuckets = std::max(1u, count / 5);	// about 5 keys per bucket
+	unsigned __int32 countSlots = std::max(1u, count + count / 50);	// 98% load of the slots
+
+	std::vector<unsigned __int64> hashes(count);
+	std::vector<unsigned __int16> pilots;
+	std::vector<unsigned __int32> slots;
+
+	// a new seed, if the pilots of a seed are not found
+	unsigned __int64 seed = 0;
+	bool found = false;
+	while (!found && seed < 16) {
+		for (unsigned __int32 i = 0; i < count; i++) {
+			hashes[i] = pyeHashKey(keys[i], seed);
+		}
+		found = build(hashes, countBuckets, countSlots, pilots, slots);
+		if (!found) {
+			seed++;
+		}
+	}
+
+	if (!found) {
+		return false;
+	}
+
+	// slots above the count of keys are remapped to the free slots below
+	std::vector<bool> taken(countSlots, false);
+	for (unsigned __int32 slot : slots) {
+		taken[slot] = true;
+	}
+
+	std::vector<unsigned __int32> remap(countSlots - count, 0);
+	unsigned __int32 slotFree = 0;
+	for (unsigned __int32 slot = count; slot < countSlots; slot++) {
+		if (taken[slot]) {
+			while (taken[slotFree]) {
+				slotFree++;
+			}
+			remap[slot - count] = slotFree++;
+		}
+	}
+
+	std::vector<unsigned __int32> offsetSlots(count, 0);
+	for (unsigned __int32 i = 0; i < count; i++) {
+		unsigned __int32 slot = slots[i];
+		if (slot >= count) {
+			slot = remap[slot - count];
+		}
+		offsetSlots[slot] = offsets[i];
+	}
+
+	std::vector<unsigned char> data;
+	data.reserve(sizeHeader + pilots.size() * 2 + remap.size() * 4 + count * 4 + 8 /*size of the list and the object*/);
+
+	WriteToVector(data, count, data.size());
+	WriteToVector(data, countBuckets, data.size());
+	WriteToVector(data, countSlots, data.size());
+	WriteToVector(data, seed, data.size());
+	for (unsigned __int16& pilot : pilots) {
+		WriteToVector(data, pilot, data.size());
+	}
+	for (unsigned __int32& slot : remap) {
+		WriteToVector(data, slot, data.size());
+	}
+	for (unsigned __int32& offset : offsetSlots) {
+		WriteToVector(data, offset, data.size());
+	}
+
+	PyeKeyDirectory::putTrailingObject(list, Str_PYEKVSPerfectHash, data);
+	return true;
+}
+
+bool PyePerfectHash::hasPerfectHash(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList) {
+	unsigned __int64 offsetData;
+	unsigned __int64 sizeData;
+	if (!PyeKeyDirectory::findTrailingObject(data, size, offsetList, Str_PYEKVSPerfectHash, offsetData, sizeData) || sizeData < sizeHeader) {
+		return false;
+	}
+
+	unsigned __int32 count, countBuckets, countSlots;
+	memcpy(&count, &data[offsetData], sizeof(count));
+	memcpy(&countBuckets, &data[offsetData + 4], sizeof(countBuckets));
+	memcpy(&countSlots, &data[offsetData + 8], sizeof(countSlots));
+
+	return countBuckets > 0 && countSlots >= count && countSlots > 0
+		&& sizeHeader + countBuckets * 2ULL + (countSlots - count) * 4ULL + count * 4ULL == sizeData;
+}
+
+bool PyePerfectHash::find(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetObject) {
+	unsigned __int64 offsetData;
+	unsigned __int64 sizeData;
+	if (!PyeKeyDirectory::findTrailingObject(data, size, offsetList, Str_PYEKVSPerfectHash, offsetData, sizeData) || sizeData < sizeHeader) {
+		return false;
+	}
+
+	unsigned __int32 count, countBuckets, countSlots;
+	unsigned __int64 seed;
+	memcpy(&count, &data[offsetData], sizeof(count));
+	memcpy(&countBuckets, &data[offsetData + 4], sizeof(countBuckets));
+	memcpy(&countSlots, &data[offsetData + 8], sizeof(countSlots));
+	memcpy(&seed, &data[offsetData + 12], sizeof(seed));
+
+	if (count == 0 || countBuckets == 0 || countSlots < count
+		|| sizeHeader + countBuckets * 2ULL + (countSlots - count) * 4ULL + count * 4ULL != sizeData) {
+		return false;
+	}
+
+	unsigned __int64 offsetPilots = offsetData + sizeHeader;
+	unsigned __int64 offsetRemap = offsetPilots + countBuckets * 2ULL;
+	unsigned __int64 offsetOffsets = offsetRemap + (countSlots - count) * 4ULL;
+
+	unsigned __int64 hash = pyeHashKey(key, seed);
+
+	unsigned __int16 pilot;
+	memcpy(&pilot, &data[offsetPilots + (hash % countBuckets) * 2], sizeof(pilot));
+
+	unsigned __int32 slot = (unsigned __int32)getSlot(hash, pilot, countSlots);
+	if (slot >= count) {
+		memcpy(&slot, &data[offsetRemap + (slot - count) * 4ULL], sizeof(slot));
+	}
+
+	unsigned __int32 offsetSlot;
+	memcpy(&offsetSlot, &data[offsetOffsets + slot * 4ULL], sizeof(offsetSlot));
+
+	// every hash gives a slot, the key of the slot must be compared
+	unsigned __int64 offsetItem = offsetList + offsetSlot;
+	if (offsetItem + 1 + key.size() > size || data[offsetItem] != key.size()
+		|| memcmp(&data[offsetItem + 1], key.data(), key.size()) != 0) {
+		return false;
+	}
+
+	offsetObject = offsetItem;
+	return true;
+}
+
+bool PyePerfectHash::getItemIdx(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, PyeItemIdx& itemIdx) {
+	if (!hasPerfectHash(data, size, offsetList)) {
+		return false;
+	}
+
+	unsigned __int64 offsetData;
+	unsigned __int64 sizeData;
+	PyeKeyDirectory::findTrailingObject(data, size, offsetList, Str_PYEKVSPerfectHash, offsetData, sizeData);
+
+	unsigned __int32 count, countBuckets, countSlots;
+	memcpy(&count, &data[offsetData], sizeof(count));
+	memcpy(&countBuckets, &data[offsetData + 4], sizeof(countBuckets));
+	memcpy(&countSlots, &data[offsetData + 8], sizeof(countSlots));
+
+	// the offsets table is the last part of the hash data
+	unsigned __int64 offsetOffsets = offsetData + sizeHeader + countBuckets * 2ULL + (countSlots - count) * 4ULL;
+	for (unsigned __int32 i = 0; i < count; i++) {
+		unsigned __int32 offsetSlot;
+		memcpy(&offsetSlot, &data[offsetOffsets + i * 4ULL], sizeof(offsetSlot));
+
+		if (!PyeKeyDirectory::addItem(data, size, offsetList + offsetSlot, itemIdx)) {
+			return false;
+		}
+	}
+
+	return true;
+}
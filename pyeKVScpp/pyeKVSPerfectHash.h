@@ -0,0 +1,117 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : minimal perfect hash indexes for immutable pyeLists
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+
+#include "pyeKVS.h"
+#include "pyeKVSDirectory.h"
+
+#pragma once
+
+/*
+* Minimal perfect hash of a pyeList
+* The hash is the last object of the list, a pyeMemory with a reserved key (see PyeKeyDirectory::putTrailingObject).
+* Name			type			size in byte		usage
+* Count			UInt32			4					count of keys (n)
+* CountBuckets	UInt32			4					count of buckets
+* CountSlots	UInt32			4					count of slots (m >= n)
+* Seed			UInt64			8					seed of the key hash
+* Pilots		UInt16			2*CountBuckets		pilot of every bucket
+* Remap			UInt32			4*(m-n)				slot below n for every slot from n to m-1
+* Offsets		UInt32			4*n					offset of the object relative to the offset of the list object
+*
+* Lookup: hash = pyeHashKey(key, Seed); bucket = hash % CountBuckets;
+* slot = mix(hash ^ Pilots[bucket]) % CountSlots; slot >= n is remapped; Offsets[slot] is the object.
+* The pilots cost about 3 bits per key, the remap table below 1 bit per key.
+*/
+
+/// <summary> Reserved key of the minimal perfect hash object </summary>
+const std::string Str_PYEKVSPerfectHash = std::string(1, Str_PYEKVSReservedKeyPrefix) + "mph";
+
+/// <summary>
+/// Minimal perfect hash index of a pyeList, which does not change after writing.
+/// Every key of the list has its own slot, a lookup reads one pilot, one offset and compares one key.
+/// The pilots are found by the "hash and displace" method: the keys are distributed to buckets,
+/// the buckets are placed from the largest to the smallest, the pilot of a bucket is the first
+/// number which moves all keys of the bucket to free slots.
+/// </summary>
+class PyePerfectHash {
+public:
+	/// <summary>
+	/// Computes the minimal perfect hash of all keys and appends it to the list.
+	/// The list must be complete and the last object in the byte stream;
+	/// items put after the hash are not found by the hash.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	/// <returns>false, if no perfect hash was found (e.g. duplicate keys)</returns>
+	static bool put(PyeList& list);
+
+	/// <summary>
+	/// Checks if a list has a valid minimal perfect hash.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <returns>true, if the list ends with a minimal perfect hash</returns>
+	static bool hasPerfectHash(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList);
+
+	static bool hasPerfectHash(const std::vector<unsigned char>& buffer, unsigned __int64 offsetList) {
+		return hasPerfectHash(buffer.data(), buffer.size(), offsetList);
+	}
+
+	/// <summary>
+	/// Finds the object of a key with the minimal perfect hash of the list.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <param name="key">key name</param>
+	/// <param name="offsetObject">offset of the pyeKVS object of the key, if found</param>
+	/// <returns>true, if found; false, if the key or the hash does not exist</returns>
+	static bool find(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetObject);
+
+	static bool find(const std::vector<unsigned char>& buffer, unsigned __int64 offsetList, const std::string& key, unsigned __int64& offsetObject) {
+		return find(buffer.data(), buffer.size(), offsetList, key, offsetObject);
+	}
+
+	/// <summary>
+	/// Gets the keys and the offsets of all objects of the list from the minimal perfect hash, without decoding the list.
+	/// </summary>
+	/// <param name="data">pointer to the byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="offsetList">offset of the pyeList object</param>
+	/// <param name="itemIdx">map to fill with key and offset of the pyeKVS objects</param>
+	/// <returns>false, if the hash does not exist</returns>
+	static bool getItemIdx(const unsigned char* data, unsigned __int64 size, unsigned __int64 offsetList, PyeItemIdx& itemIdx);
+
+private:
+	/// <summary> Size of the header: count, count of buckets, count of slots and seed </summary>
+	static const unsigned __int64 sizeHeader = 20;
+
+	/// <summary>
+	/// Gets the slot of a key hash with the pilot of its bucket.
+	/// </summary>
+	static unsigned __int64 getSlot(unsigned __int64 hash, unsigned __int16 pilot, unsigned __int32 countSlots) {
+		unsigned __int64 slot = hash ^ ((pilot + 1ULL) * 0x9e3779b97f4a7c15ULL);
+		slot ^= slot >> 31;
+		slot *= 0xbf58476d1ce4e5b9ULL;
+		slot ^= slot >> 29;
+		return slot % countSlots;
+	}
+
+	/// <summary>
+	/// Tries to find the pilots of all buckets for a seed.
+	/// </summary>
+	static bool build(const std::vector<unsigned __int64>& hashes, unsigned __int32 countBuckets, unsigned __int32 countSlots,
+		std::vector<unsigned __int16>& pilots, std::vector<unsigned __int32>& slots);
+};
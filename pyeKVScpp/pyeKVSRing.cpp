@@ -0,0 +1,142 @@
+//#include "pch.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstring>
+
+#include "pyeKVSRing.h"
+
+
+unsigned __int64 PyeRingBuffer::getTailMin() const {
+	unsigned __int64 tailMin = _head->position.load(std::memory_order_relaxed);
+	for (unsigned int i = 0; i < _countConsumers; i++) {
+		tailMin = std::min(tailMin, _tails[i].position.load(std::memory_order_acquire));
+	}
+	return tailMin;
+}
+
+unsigned char* PyeRingBuffer::tryReserve(size_t size) {
+	unsigned __int64 sizeFrame = alignFrame(size);
+	if (size < sizeHeader || sizeFrame > _buffer.size()) {
+		return nullptr;
+	}
+
+	unsigned __int64 head = _head->position.load(std::memory_order_relaxed);
+	unsigned __int64 offset = head & _mask;
+
+	// a frame does not wrap around the end of the ring: the bytes up to the end are published as padding first,
+	// so the frame waits only for the consumers to read the start of the ring, not for padding and frame together
+	if (offset + sizeFrame > _buffer.size()) {
+		unsigned __int64 sizePadding = _buffer.size() - offset;
+		if (head + sizePadding - getTailMin() > _buffer.size()) {
+			return nullptr;
+		}
+
+		if (sizePadding >= sizeHeader) {
+			unsigned char* padding = &_buffer[offset];
+			unsigned __int64 sizeSkip = sizePadding - sizeHeader;
+			memcpy(padding, "PYEP", 4);
+			memset(padding + 4, 0, 4);
+			memcpy(padding + 8, &sizeSkip, sizeof(sizeSkip));
+		}
+
+		head += sizePadding;
+		_head->position.store(head, std::memory_order_release);
+	}
+
+	if (head + sizeFrame - getTailMin() > _buffer.size()) {
+		return nullptr;
+	}
+
+	_reserved = head;
+	return &_buffer[_reserved & _mask];
+}
+
+unsigned char* PyeRingBuffer::reserve(size_t size) {
+	if (size < sizeHeader || alignFrame(size) > _buffer.size()) {
+		return nullptr;
+	}
+
+	for (;;) {
+		unsigned char* frame = tryReserve(size);
+		if (frame) {
+			return frame;
+		}
+		if (_closed.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		std::this_thread::yield();
+	}
+}
+
+void PyeRingBuffer::commit() {
+	unsigned __int64 sizeData;
+	memcpy(&sizeData, &_buffer[(_reserved & _mask) + 8], sizeof(sizeData));
+
+	_head->position.store(_reserved + alignFrame(sizeHeader + sizeData), std::memory_order_release);
+}
+
+bool PyeRingBuffer::publish(const PyeByteSpan& document) {
+	if (document.size() < sizeHeader) {
+		return false;
+	}
+
+	// the size in the header must give the length of the frame
+	unsigned __int64 sizeData;
+	memcpy(&sizeData, document.data() + 8, sizeof(sizeData));
+	if (sizeHeader + sizeData != document.size()) {
+		return false;
+	}
+
+	unsigned char* frame = reserve(document.size());
+	if (!frame) {
+		return false;
+	}
+
+	memcpy(frame, document.data(), document.size());
+	commit();
+	return true;
+}
+
+bool PyeRingBuffer::read(unsigned int consumer, PyeByteSpan& document) {
+	unsigned __int64 tail = _tails[consumer].position.load(std::memory_order_relaxed);
+
+	for (;;) {
+		unsigned __int64 head = _head->position.load(std::memory_order_acquire);
+		if (tail == head) {
+			// all padding frames before the next document are skipped
+			_tails[consumer].position.store(tail, std::memory_order_release);
+			return false;
+		}
+
+		unsigned __int64 offset = tail & _mask;
+		if (_buffer.size() - offset < sizeHeader) {
+			tail += _buffer.size() - offset;
+			continue;
+		}
+
+		const unsigned char* frame = &_buffer[offset];
+
+		unsigned __int64 sizeData;
+		memcpy(&sizeData, frame + 8, sizeof(sizeData));
+
+		if (memcmp(frame, "PYEP", 4) == 0) {
+			tail += sizeHeader + sizeData;
+			continue;
+		}
+
+		_tails[consumer].position.store(tail, std::memory_order_release);
+		document = PyeByteSpan(frame, (size_t)(sizeHeader + sizeData));
+		return true;
+	}
+}
+
+void PyeRingBuffer::release(unsigned int consumer) {
+	unsigned __int64 tail = _tails[consumer].position.load(std::memory_order_relaxed);
+
+	unsigned __int64 sizeData;
+	memcpy(&sizeData, &_buffer[(tail & _mask) + 8], sizeof(sizeData));
+
+	_tails[consumer].position.store(tail + alignFrame(sizeHeader + sizeData), std::memory_order_release);
+}
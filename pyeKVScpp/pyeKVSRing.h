@@ -0,0 +1,172 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : single producer, multi consumer ring buffer of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <new>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Frames in the ring buffer
+* Every frame is a pyeKVS document: the 16-byte document header (PYES, version, size) and the root list.
+* The size of the header gives the length of the frame. Frames start at a multiple of 8 bytes.
+* A frame does not wrap around the end of the ring. The bytes up to the end are skipped by
+* a padding frame (prefix PYEP, size of the skipped bytes behind the header) or, if less than 16 bytes remain, implicitly.
+* The padding is published before the frame, so a frame up to the size of the ring fits, when the consumers have read the padding.
+*/
+
+/// <summary>
+/// Lock-free ring buffer, which hands pyeKVS documents from one producer thread to several consumer threads.
+/// Every consumer reads every document in place (broadcast); the producer waits for the slowest consumer.
+/// The producer writes a document with publish, or encodes it itself into the ring with reserve and commit.
+/// A consumer gets the next document with read and gives its bytes free with release.
+/// </summary>
+class PyeRingBuffer {
+	/// <summary> Size of a cache line </summary>
+	static const size_t sizeCacheLine = 64;
+
+	/// <summary> Cursor (count of bytes), padded to a cache line </summary>
+	struct Cursor {
+		std::atomic<unsigned __int64> position{ 0 };
+		unsigned char padding[sizeCacheLine - sizeof(std::atomic<unsigned __int64>)];
+	};
+
+	std::vector<unsigned char> _buffer;
+	unsigned __int64 _mask;
+
+	/// <summary> Memory of the cursors; every cursor starts at a cache line (no over-aligned new in C++14) </summary>
+	std::vector<unsigned char> _cursors;
+
+	/// <summary> Write cursor of the producer </summary>
+	Cursor* _head;
+
+	/// <summary> Position of the reserved frame; only used by the producer </summary>
+	unsigned __int64 _reserved = 0;
+
+	/// <summary> Read cursors of the consumers </summary>
+	Cursor* _tails;
+	unsigned int _countConsumers;
+
+	std::atomic<bool> _closed{ false };
+
+public:
+	/// <summary> Size of the frame header (pyeKVS document header) </summary>
+	static const size_t sizeHeader = 16;
+
+	/// <summary>
+	/// Constructor of a ring buffer
+	/// </summary>
+	/// <param name="capacity">size of the ring in bytes; rounded up to a power of 2</param>
+	/// <param name="countConsumers">count of consumers; every consumer reads every document</param>
+	PyeRingBuffer(size_t capacity, unsigned int countConsumers) {
+		size_t size = 64;
+		while (size < capacity) {
+			size *= 2;
+		}
+		_buffer.resize(size);
+		_mask = size - 1;
+
+		// the producer cursor and the consumer cursors, each on an own cache line
+		_countConsumers = countConsumers;
+		_cursors.resize((countConsumers + 1) * sizeCacheLine + sizeCacheLine - 1);
+		unsigned char* cursors = _cursors.data() + (sizeCacheLine - (size_t)_cursors.data() % sizeCacheLine) % sizeCacheLine;
+		_head = new (cursors) Cursor();
+		_tails = (Cursor*)(cursors + sizeCacheLine);
+		for (unsigned int i = 0; i < countConsumers; i++) {
+			new (cursors + (i + 1) * sizeCacheLine) Cursor();
+		}
+	}
+
+	PyeRingBuffer(const PyeRingBuffer&) = delete;
+	PyeRingBuffer& operator=(const PyeRingBuffer&) = delete;
+
+	size_t getCapacity() const {
+		return _buffer.size();
+	}
+
+	unsigned int getCountConsumers() const {
+		return _countConsumers;
+	}
+
+	/// <summary>
+	/// Reserves space for a document of the producer, without waiting.
+	/// </summary>
+	/// <param name="size">size of the document with header</param>
+	/// <returns>pointer to write the document to; nullptr, if the ring is full or the document larger than the ring</returns>
+	unsigned char* tryReserve(size_t size);
+
+	/// <summary>
+	/// Reserves space for a document of the producer and waits for the consumers, if the ring is full.
+	/// </summary>
+	/// <param name="size">size of the document with header</param>
+	/// <returns>pointer to write the document to; nullptr, if the document is larger than the ring or the ring is closed</returns>
+	unsigned char* reserve(size_t size);
+
+	/// <summary>
+	/// Publishes the reserved document to the consumers. The header of the document gives its size.
+	/// </summary>
+	void commit();
+
+	/// <summary>
+	/// Copies a document to the ring and publishes it; waits, if the ring is full.
+	/// </summary>
+	/// <param name="document">bytes of the pyeKVS document</param>
+	/// <returns>false, if the document is larger than the ring, has no valid header or the ring is closed</returns>
+	bool publish(const PyeByteSpan& document);
+
+	bool publish(PyeDocument& document) {
+		return publish(PyeByteSpan(*document.getBuffer()));
+	}
+
+	/// <summary>
+	/// Gets the next document of a consumer without a copy. The bytes stay valid until release.
+	/// </summary>
+	/// <param name="consumer">index of the consumer</param>
+	/// <param name="document">gets the bytes of the document</param>
+	/// <returns>false, if no new document is published</returns>
+	bool read(unsigned int consumer, PyeByteSpan& document);
+
+	/// <summary>
+	/// Gives the document of the last read of a consumer free.
+	/// </summary>
+	/// <param name="consumer">index of the consumer</param>
+	void release(unsigned int consumer);
+
+	/// <summary>
+	/// Closes the ring: the producer publishes no more documents, consumers read the remaining documents.
+	/// </summary>
+	void close() {
+		_closed.store(true, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Checks, if the ring is closed and a consumer has read all documents.
+	/// </summary>
+	bool isFinished(unsigned int consumer) const {
+		return _closed.load(std::memory_order_acquire)
+			&& _tails[consumer].position.load(std::memory_order_relaxed) == _head->position.load(std::memory_order_acquire);
+	}
+
+private:
+	static unsigned __int64 alignFrame(unsigned __int64 size) {
+		return (size + 7) & ~7ULL;
+	}
+
+	/// <summary>
+	/// Gets the position of the slowest consumer.
+	/// </summary>
+	unsigned __int64 getTailMin() const;
+};
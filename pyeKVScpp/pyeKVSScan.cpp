@@ -0,0 +1,205 @@
+//#include "pch.h"
+
+#include <vector>
+#include <cstring>
+
+#include "pyeKVSScan.h"
+
+
+/// <summary>
+/// Applies a compare operator to the result of a three-way comparison.
+/// </summary>
+static bool pyeScanCompare(int result, pyeScanOperator compare) {
+	switch (compare) {
+	case pyeScanEqual:
+		return result == 0;
+	case pyeScanNotEqual:
+		return result != 0;
+	case pyeScanLess:
+		return result < 0;
+	case pyeScanLessEqual:
+		return result <= 0;
+	case pyeScanGreater:
+		return result > 0;
+	case pyeScanGreaterEqual:
+		return result >= 0;
+	default:
+		return false;
+	}
+}
+
+template<class T>
+static int pyeScanThreeWay(T a, T b) {
+	return (a < b) ? -1 : ((b < a) ? 1 : 0);
+}
+
+bool PyeScan::prepare(PyeArrayMap& arrayMap) {
+	unsigned __int16 mapLength = arrayMap.getMapLength();
+	const std::vector<unsigned char>& buffer = *arrayMap.getBuffer();
+	unsigned __int64 offsetMapStruct = arrayMap.getOffsetValue() + 3 /*pyeValueType(1 byte) + information length of map (2 byte)*/;
+
+	_mapStruct.assign((const pyeValueType*)&buffer[offsetMapStruct], (const pyeValueType*)&buffer[offsetMapStruct] + mapLength);
+	_offsetValues.resize(mapLength);
+	_offsetColumns.resize(mapLength);
+
+	// rows with only fixed-size values have a constant stride
+	bool fixedSize = true;
+	_stride = 0;
+	for (unsigned __int16 i = 0; i < mapLength; i++) {
+		_offsetColumns[i] = _stride;
+		_stride += getSizeOfFundamentalValueType(_mapStruct[i]);
+		fixedSize = fixedSize && _mapStruct[i] != pyeValueType::pyeStringUTF8S
+			&& _mapStruct[i] != pyeValueType::pyeStringUTF8L && _mapStruct[i] != pyeValueType::pyeMemory;
+	}
+	if (!fixedSize) {
+		_stride = 0;
+	}
+
+	for (const PyeScanPredicate& predicate : _predicates) {
+		if (predicate.column >= mapLength) {
+			return false;
+		}
+
+		switch (_mapStruct[predicate.column]) {
+		case pyeValueType::pyeStringUTF8S:
+		case pyeValueType::pyeStringUTF8L:
+			if (predicate.domain != PyeScanPredicate::String) {
+				return false;
+			}
+			break;
+		case pyeValueType::pyeInt128:
+		case pyeValueType::pyeUInt128:
+		case pyeValueType::pyeFloat128:
+		case pyeValueType::pyeMemory:
+			return false;
+		default:
+			if (predicate.domain == PyeScanPredicate::String) {
+				return false;
+			}
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool PyeScan::isMatch(const std::vector<unsigned char>& buffer) const {
+	for (const PyeScanPredicate& predicate : _predicates) {
+		if (!isMatch(buffer, predicate)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PyeScan::isMatch(const std::vector<unsigned char>& buffer, const PyeScanPredicate& predicate) const {
+	pyeValueType valueType = _mapStruct[predicate.column];
+	unsigned __int64 offset = _offsetValues[predicate.column];
+
+	__int64 valueSigned = 0;
+	unsigned __int64 valueUnsigned = 0;
+	double valueFloat = 0;
+
+	switch (valueType) {
+	case pyeValueType::pyeZero:
+		break;
+	case pyeValueType::pyeBool:
+		valueUnsigned = 1;
+		break;
+	case pyeValueType::pyeInt8:
+		valueSigned = (__int8)buffer[offset];
+		break;
+	case pyeValueType::pyeUInt8:
+		valueUnsigned = buffer[offset];
+		break;
+	case pyeValueType::pyeInt16: {
+		__int16 value;
+		ReadFromVector(value, buffer, offset);
+		valueSigned = value;
+		break;
+	}
+	case pyeValueType::pyeUInt16: {
+		unsigned __int16 value;
+		ReadFromVector(value, buffer, offset);
+		valueUnsigned = value;
+		break;
+	}
+	case pyeValueType::pyeInt32: {
+		__int32 value;
+		ReadFromVector(value, buffer, offset);
+		valueSigned = value;
+		break;
+	}
+	case pyeValueType::pyeUInt32: {
+		unsigned __int32 value;
+		ReadFromVector(value, buffer, offset);
+		valueUnsigned = value;
+		break;
+	}
+	case pyeValueType::pyeInt64:
+		ReadFromVector(valueSigned, buffer, offset);
+		break;
+	case pyeValueType::pyeUInt64:
+		ReadFromVector(valueUnsigned, buffer, offset);
+		break;
+	case pyeValueType::pyeFloat32: {
+		float value;
+		ReadFromVector(value, buffer, offset);
+		return pyeScanCompare(pyeScanThreeWay(value, (float)predicate.valueFloat), predicate.compare);
+	}
+	case pyeValueType::pyeFloat64:
+		ReadFromVector(valueFloat, buffer, offset);
+		return pyeScanCompare(pyeScanThreeWay(valueFloat, predicate.valueFloat), predicate.compare);
+	case pyeValueType::pyeStringUTF8S:
+	case pyeValueType::pyeStringUTF8L: {
+		// compare in place, without a copy of the string
+		unsigned __int64 length;
+		if (valueType == pyeValueType::pyeStringUTF8S) {
+			length = buffer[offset];
+			offset += 1;
+		}
+		else {
+			unsigned __int32 lengthL;
+			ReadFromVector(lengthL, buffer, offset);
+			length = lengthL;
+			offset += 4;
+		}
+		size_t lengthCompare = (size_t)std::min<unsigned __int64>(length, predicate.valueString.size());
+		int result = lengthCompare > 0 ? memcmp(&buffer[offset], predicate.valueString.data(), lengthCompare) : 0;
+		if (result == 0) {
+			result = pyeScanThreeWay<unsigned __int64>(length, predicate.valueString.size());
+		}
+		return pyeScanCompare(result, predicate.compare);
+	}
+	default:
+		return false;
+	}
+
+	bool isSigned = valueType == pyeValueType::pyeInt8 || valueType == pyeValueType::pyeInt16
+		|| valueType == pyeValueType::pyeInt32 || valueType == pyeValueType::pyeInt64;
+
+	if (predicate.domain == PyeScanPredicate::Float) {
+		valueFloat = isSigned ? (double)valueSigned : (double)valueUnsigned;
+		return pyeScanCompare(pyeScanThreeWay(valueFloat, predicate.valueFloat), predicate.compare);
+	}
+
+	int result;
+	if (isSigned) {
+		if (predicate.domain == PyeScanPredicate::Unsigned && predicate.valueUnsigned > (unsigned __int64)INT64_MAX) {
+			result = -1;
+		}
+		else {
+			result = pyeScanThreeWay(valueSigned, predicate.valueSigned);
+		}
+	}
+	else {
+		if (predicate.domain == PyeScanPredicate::Signed && predicate.valueSigned < 0) {
+			result = 1;
+		}
+		else {
+			result = pyeScanThreeWay(valueUnsigned, predicate.valueUnsigned);
+		}
+	}
+
+	return pyeScanCompare(result, predicate.compare);
+}
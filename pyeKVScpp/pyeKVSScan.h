@@ -0,0 +1,284 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : column projection and predicate scans over pyeArrayMaps
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Usage:
+*	PyeScan scan;
+*	scan.where(2, pyeScanGreater, 20.5).where(0, pyeScanEqual, 7);
+*
+*	std::vector<unsigned __int32> rows;
+*	scan.scan(arrayMap, rows);						// indexes of the matching rows
+*
+*	std::vector<double> values;
+*	scan.scan(arrayMap, 1, values);					// values of column 1 of the matching rows
+*
+*	scan.scanRows(arrayMap, [&](unsigned __int32 row, const PyeScanRow& values) {
+*		sum += values.get<double>(1) * values.get<__int32>(3);
+*	});
+*/
+
+/// <summary>
+/// Compare operators of scan predicates
+/// </summary>
+enum pyeScanOperator : unsigned __int8 {
+	pyeScanEqual,
+	pyeScanNotEqual,
+	pyeScanLess,
+	pyeScanLessEqual,
+	pyeScanGreater,
+	pyeScanGreaterEqual
+};
+
+/// <summary>
+/// Predicate of a scan: compares the value of a column with a constant value.
+/// The constant is stored as signed, unsigned or floating point number or as string,
+/// the value of the column is compared in the domain of the column type.
+/// </summary>
+struct PyeScanPredicate {
+	/// <summary> Domain of the constant value </summary>
+	enum Domain : unsigned __int8 { Signed, Unsigned, Float, String };
+
+	unsigned __int16 column = 0;
+	pyeScanOperator compare = pyeScanEqual;
+	Domain domain = Signed;
+	__int64 valueSigned = 0;
+	unsigned __int64 valueUnsigned = 0;
+	double valueFloat = 0;
+	std::string valueString;
+};
+
+/// <summary>
+/// Values of the current row of a scan. Holds only the offsets of the values in the byte stream,
+/// the values are read on request.
+/// </summary>
+class PyeScanRow {
+	const std::vector<unsigned char>* _buffer = nullptr;
+	const pyeValueType* _mapStruct = nullptr;
+	const unsigned __int64* _offsetValues = nullptr;
+
+public:
+	PyeScanRow(const std::vector<unsigned char>* buffer, const pyeValueType* mapStruct, const unsigned __int64* offsetValues) :
+		_buffer(buffer), _mapStruct(mapStruct), _offsetValues(offsetValues) {}
+
+	/// <summary>
+	/// Gets the value of a column of the row.
+	/// </summary>
+	/// <typeparam name="V">C++ type of the value; must match the pye value type of the column</typeparam>
+	/// <param name="column">index of the column</param>
+	/// <returns>value</returns>
+	template<class V>
+	V get(unsigned __int16 column) const {
+		return PyeValueTypeTraits<V>::read(*_buffer, _offsetValues[column], _mapStruct[column]);
+	}
+
+	/// <summary>
+	/// Gets the pye value type of a column.
+	/// </summary>
+	/// <param name="column">index of the column</param>
+	/// <returns>pye value type</returns>
+	pyeValueType getValueType(unsigned __int16 column) const {
+		return _mapStruct[column];
+	}
+
+	/// <summary>
+	/// Gets the offset of the value of a column in the byte stream.
+	/// </summary>
+	/// <param name="column">index of the column</param>
+	/// <returns>offset</returns>
+	unsigned __int64 getOffsetValue(unsigned __int16 column) const {
+		return _offsetValues[column];
+	}
+};
+
+/// <summary>
+/// Scan of the rows of a pyeArrayMap with predicates.
+/// All predicates must be true for a matching row.
+/// The rows are walked once in the order of the byte stream, every value is decoded in place
+/// without a copy. The working memory is kept in the scan object, so repeated scans
+/// and the output vectors (cleared, not shrinked) do not allocate in the steady state.
+/// </summary>
+class PyeScan {
+	/// <summary> Predicates of the scan </summary>
+	std::vector<PyeScanPredicate> _predicates;
+
+	/// <summary> MapStruct of the scanned pyeArrayMap </summary>
+	std::vector<pyeValueType> _mapStruct;
+
+	/// <summary> Offsets of the values of the current row </summary>
+	std::vector<unsigned __int64> _offsetValues;
+
+	/// <summary> Offsets of the values in a row; only used with a constant stride </summary>
+	std::vector<unsigned __int64> _offsetColumns;
+
+	/// <summary> Size of a row, if all values have a fixed size; otherwise 0 </summary>
+	unsigned __int64 _stride = 0;
+
+public:
+	/// <summary>
+	/// Adds a predicate with a number.
+	/// </summary>
+	/// <typeparam name="V">C++ number type</typeparam>
+	/// <param name="column">index of the column</param>
+	/// <param name="compare">compare operator; column value [operator] value</param>
+	/// <param name="value">value</param>
+	/// <returns>this</returns>
+	template<class V>
+	PyeScan& where(unsigned __int16 column, pyeScanOperator compare, V value) {
+		static_assert(std::is_arithmetic<V>::value, "the value of a predicate must be a number or a string");
+
+		PyeScanPredicate predicate;
+		predicate.column = column;
+		predicate.compare = compare;
+		if (std::is_floating_point<V>::value) {
+			predicate.domain = PyeScanPredicate::Float;
+		}
+		else if (std::is_signed<V>::value) {
+			predicate.domain = PyeScanPredicate::Signed;
+		}
+		else {
+			predicate.domain = PyeScanPredicate::Unsigned;
+		}
+		predicate.valueSigned = (__int64)value;
+		predicate.valueUnsigned = (unsigned __int64)value;
+		predicate.valueFloat = (double)value;
+
+		_predicates.push_back(predicate);
+		return *this;
+	}
+
+	/// <summary>
+	/// Adds a predicate with a string.
+	/// </summary>
+	/// <param name="column">index of the column</param>
+	/// <param name="compare">compare operator; column value [operator] value</param>
+	/// <param name="value">value</param>
+	/// <returns>this</returns>
+	PyeScan& where(unsigned __int16 column, pyeScanOperator compare, const std::string& value) {
+		PyeScanPredicate predicate;
+		predicate.column = column;
+		predicate.compare = compare;
+		predicate.domain = PyeScanPredicate::String;
+		predicate.valueString = value;
+
+		_predicates.push_back(predicate);
+		return *this;
+	}
+
+	PyeScan& where(unsigned __int16 column, pyeScanOperator compare, const char* value) {
+		return where(column, compare, std::string(value));
+	}
+
+	/// <summary>
+	/// Removes all predicates.
+	/// </summary>
+	void clear() {
+		_predicates.clear();
+	}
+
+	/// <summary>
+	/// Gets the indexes of all matching rows.
+	/// </summary>
+	/// <param name="arrayMap">pyeArrayMap</param>
+	/// <param name="rows">vector for the row indexes; cleared before the scan</param>
+	/// <returns>false, if a predicate does not fit to the mapStruct</returns>
+	bool scan(PyeArrayMap& arrayMap, std::vector<unsigned __int32>& rows) {
+		rows.clear();
+		return scanRows(arrayMap, [&](unsigned __int32 row, const PyeScanRow& /*values*/) {
+			rows.push_back(row);
+		});
+	}
+
+	/// <summary>
+	/// Gets the values of one column of all matching rows.
+	/// </summary>
+	/// <typeparam name="V">C++ type of the values; must match the pye value type of the column</typeparam>
+	/// <param name="arrayMap">pyeArrayMap</param>
+	/// <param name="column">index of the projected column</param>
+	/// <param name="values">vector for the values; cleared before the scan</param>
+	/// <returns>false, if a predicate or the projected column does not fit to the mapStruct or is not readable as V</returns>
+	template<class V>
+	bool scan(PyeArrayMap& arrayMap, unsigned __int16 column, std::vector<V>& values) {
+		values.clear();
+		if (column >= arrayMap.getMapLength() || !pyeIsReadableAs<V>(arrayMap.getMapStruct()[column])) {
+			return false;
+		}
+		return scanRows(arrayMap, [&](unsigned __int32 /*row*/, const PyeScanRow& rowValues) {
+			values.push_back(rowValues.get<V>(column));
+		});
+	}
+
+	/// <summary>
+	/// Calls a function for every matching row. The function gets the index of the row
+	/// and the values of the row, to read the projected columns.
+	/// </summary>
+	/// <typeparam name="F">function void(unsigned __int32 row, const PyeScanRow&amp; values)</typeparam>
+	/// <param name="arrayMap">pyeArrayMap</param>
+	/// <param name="visit">function</param>
+	/// <returns>false, if a predicate does not fit to the mapStruct</returns>
+	template<class F>
+	bool scanRows(PyeArrayMap& arrayMap, F visit) {
+		if (!prepare(arrayMap)) {
+			return false;
+		}
+
+		const std::vector<unsigned char>& buffer = *arrayMap.getBuffer();
+		unsigned __int32 count = arrayMap.getCount();
+		unsigned __int64 offset = arrayMap.getOffsetFirstItem();
+		size_t mapLength = _mapStruct.size();
+		PyeScanRow rowValues(&buffer, _mapStruct.data(), _offsetValues.data());
+
+		for (unsigned __int32 row = 0; row < count; row++) {
+			if (_stride > 0) {
+				for (size_t i = 0; i < mapLength; i++) {
+					_offsetValues[i] = offset + _offsetColumns[i];
+				}
+				offset += _stride;
+			}
+			else {
+				for (size_t i = 0; i < mapLength; i++) {
+					_offsetValues[i] = offset;
+					offset += getSizeOfValueData(buffer, offset, _mapStruct[i]);
+				}
+			}
+
+			if (isMatch(buffer)) {
+				visit(row, rowValues);
+			}
+		}
+
+		return true;
+	}
+
+private:
+	/// <summary>
+	/// Reads the mapStruct and checks the predicates.
+	/// </summary>
+	bool prepare(PyeArrayMap& arrayMap);
+
+	/// <summary>
+	/// Checks all predicates with the values of the current row.
+	/// </summary>
+	bool isMatch(const std::vector<unsigned char>& buffer) const;
+
+	/// <summary>
+	/// Checks one predicate with the value of the current row.
+	/// </summary>
+	bool isMatch(const std::vector<unsigned char>& buffer, const PyeScanPredicate& predicate) const;
+};
@@ -0,0 +1,368 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : compile-time schemas for typed access to C++ structs
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <array>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Usage:
+*	struct SensorMsg { __int32 id; double value; std::string unit; };
+*
+*	PYE_SCHEMA(SensorMsg,
+*		PYE_FIELD(SensorMsg, id),
+*		PYE_FIELD(SensorMsg, value),
+*		PYE_FIELD(SensorMsg, unit));
+*
+*	PyeSchemaCodec<SensorMsg>::put(list, msg);		// one object per field, key = member name
+*
+*	PyeSchemaReader<SensorMsg> reader;
+*	reader.bind(list);								// resolves the offsets of all fields once
+*	reader.read(msg);								// direct loads of the values
+*
+*	PyeSchemaRows<SensorMsg>::put(list, "rows", msgs);	// vector of structs as pyeArrayMap rows
+*	PyeSchemaRows<SensorMsg>::get(arrayMap, msgs);
+*
+* The C++ type of every member needs a PyeValueTypeTraits specialization.
+*/
+
+/// <summary>
+/// Field of a schema: key name and pointer to the member of the struct.
+/// </summary>
+/// <typeparam name="S">struct</typeparam>
+/// <typeparam name="M">C++ type of the member</typeparam>
+template<class S, class M>
+struct PyeSchemaField {
+	typedef M MemberType;
+
+	const char* key;
+	M S::* member;
+};
+
+template<class S, class M>
+PyeSchemaField<S, M> pyeSchemaField(const char* key, M S::* member) {
+	return PyeSchemaField<S, M>{ key, member };
+}
+
+/// <summary>
+/// Schema of a struct. The specialization is created by the macro PYE_SCHEMA and
+/// gives the tuple of all fields.
+/// </summary>
+/// <typeparam name="S">struct</typeparam>
+template<class S>
+struct PyeSchema;
+
+/// <summary> Field of a schema with the member name as key </summary>
+#define PYE_FIELD(Struct, member) pyeSchemaField(#member, &Struct::member)
+
+/// <summary> Field of a schema with an own key name </summary>
+#define PYE_FIELD_KEY(Struct, member, key) pyeSchemaField(key, &Struct::member)
+
+/// <summary> Declares the schema of a struct; use at global scope </summary>
+#define PYE_SCHEMA(Struct, ...) \
+	template<> struct PyeSchema<Struct> { \
+		static auto fields() { \
+			return std::make_tuple(__VA_ARGS__); \
+		} \
+	}
+
+/// <summary>
+/// Calls a function for every field of a schema with the field and its index.
+/// </summary>
+template<class Tuple, class F, size_t... I>
+void pyeForEachField(const Tuple& fields, F& function, std::index_sequence<I...>) {
+	int expand[] = { 0, (function(std::get<I>(fields), I), 0)... };
+	(void)expand;
+}
+
+template<class Tuple, class F>
+void pyeForEachField(const Tuple& fields, F function) {
+	pyeForEachField(fields, function, std::make_index_sequence<std::tuple_size<Tuple>::value>());
+}
+
+/// <summary>
+/// Encodes a struct with a schema to a pyeList.
+/// </summary>
+/// <typeparam name="S">struct with a PYE_SCHEMA</typeparam>
+template<class S>
+class PyeSchemaCodec {
+public:
+	typedef decltype(PyeSchema<S>::fields()) Fields;
+
+	/// <summary> Count of fields of the schema </summary>
+	static const size_t countFields = std::tuple_size<Fields>::value;
+
+	/// <summary>
+	/// Puts all fields of the struct to the list. The fields are encoded in one step
+	/// and added with one header update.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	/// <param name="value">struct</param>
+	static void put(PyeList& list, const S& value) {
+		std::vector<unsigned char> objects;
+		std::vector<unsigned __int64> offsetObjects;
+		offsetObjects.reserve(countFields);
+
+		pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t /*idxField*/) {
+			typedef typename std::decay<decltype(field)>::type::MemberType M;
+			const M& member = value.*(field.member);
+
+			offsetObjects.push_back(objects.size());
+
+			unsigned __int8 keySize = (unsigned __int8)strlen(field.key);
+			objects.push_back(keySize);
+			objects.insert(objects.end(), field.key, field.key + keySize);
+
+			objects.push_back(PyeValueTypeTraits<M>::getValueType(member));
+			PyeValueTypeTraits<M>::write(objects, member);
+		});
+
+		list.putRaw(objects, offsetObjects);
+	}
+};
+
+/// <summary>
+/// Reads structs with a schema from a pyeList or a PyeListView.
+/// bind() looks up the keys of all fields once and stores the offsets of the values,
+/// read() copies the values without any further lookup.
+/// </summary>
+/// <typeparam name="S">struct with a PYE_SCHEMA</typeparam>
+template<class S>
+class PyeSchemaReader {
+	static const size_t countFields = PyeSchemaCodec<S>::countFields;
+
+	/// <summary> Pointer to the byte buffer </summary>
+	const std::vector<unsigned char>* _buffer = nullptr;
+
+	/// <summary> Offsets of the value data of the fields; 0 if the field is not in the list </summary>
+	std::array<unsigned __int64, countFields> _offsetValues;
+
+	/// <summary> Stored pye value types of the fields </summary>
+	std::array<pyeValueType, countFields> _valueTypes;
+
+public:
+	PyeSchemaReader() {
+		_offsetValues.fill(0);
+		_valueTypes.fill(pyeValueType::pyeUnknown);
+	}
+
+	/// <summary>
+	/// Resolves the offsets of all fields in the list.
+	/// Fields with a missing key or a not readable value type are skipped by read().
+	/// The values are read from a std::vector: a PyeListView of a byte span binds no field.
+	/// </summary>
+	/// <typeparam name="L">PyeList or PyeListView</typeparam>
+	/// <param name="list">list with the encoded struct</param>
+	/// <returns>true, if all fields are found; false for a PyeListView of a byte span</returns>
+	template<class L>
+	bool bind(L& list) {
+		_buffer = list.getBuffer();
+		_offsetValues.fill(0);
+		_valueTypes.fill(pyeValueType::pyeUnknown);
+		if (_buffer == nullptr) {
+			return false;
+		}
+
+		const std::vector<unsigned char>& buffer = *_buffer;
+		const PyeItemIdx& itemIdx = list.getItemIdx();
+		bool complete = true;
+
+		pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t idxField) {
+			typedef typename std::decay<decltype(field)>::type::MemberType M;
+
+			auto item = itemIdx.find(field.key);
+			if (item == itemIdx.end()) {
+				complete = false;
+				return;
+			}
+
+			unsigned __int64 offsetValue = item->second + 1 /*information key size*/ + buffer[item->second];
+			pyeValueType valueType = (pyeValueType)buffer[offsetValue];
+			if (!pyeIsReadableAs<M>(valueType)) {
+				complete = false;
+				return;
+			}
+
+			_offsetValues[idxField] = offsetValue + 1 /*pye value type*/;
+			_valueTypes[idxField] = valueType;
+		});
+
+		return complete;
+	}
+
+	/// <summary>
+	/// Checks if a field was found by bind().
+	/// </summary>
+	/// <param name="idxField">index of the field in the schema</param>
+	/// <returns>true, if the field is readable</returns>
+	bool isBound(size_t idxField) const {
+		return _offsetValues[idxField] != 0;
+	}
+
+	/// <summary>
+	/// Reads all bound fields into the struct.
+	/// </summary>
+	/// <param name="value">struct</param>
+	void read(S& value) const {
+		pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t idxField) {
+			typedef typename std::decay<decltype(field)>::type::MemberType M;
+
+			if (_offsetValues[idxField] != 0) {
+				value.*(field.member) = PyeValueTypeTraits<M>::read(*_buffer, _offsetValues[idxField], _valueTypes[idxField]);
+			}
+		});
+	}
+};
+
+/// <summary>
+/// Writes and reads vectors of structs with a schema as rows of a pyeArrayMap.
+/// The mapStruct is derived from the schema, one column per field in the order of the schema.
+/// Rows are encoded into one block and appended with one header update.
+/// Structs with only fixed-size fields are read with a constant row stride.
+/// </summary>
+/// <typeparam name="S">struct with a PYE_SCHEMA</typeparam>
+template<class S>
+class PyeSchemaRows {
+	static const size_t countFields = PyeSchemaCodec<S>::countFields;
+
+public:
+	/// <summary>
+	/// Gets the mapStruct of the schema.
+	/// </summary>
+	/// <returns>vector of pye value types, one per field</returns>
+	static std::vector<pyeValueType> getMapStruct() {
+		std::vector<pyeValueType> mapStruct;
+
+		pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t /*idxField*/) {
+			typedef typename std::decay<decltype(field)>::type::MemberType M;
+			static_assert(!std::is_same<M, bool>::value, "bool has no value data in a pyeArrayMap, use unsigned __int8");
+
+			const pyeValueType valueType = PyeValueTypeTraits<M>::valueType;
+			mapStruct.push_back(valueType);
+		});
+
+		return mapStruct;
+	}
+
+	/// <summary>
+	/// Puts a vector of structs as new pyeArrayMap to the list.
+	/// </summary>
+	/// <param name="list">pyeList</param>
+	/// <param name="key">key name of the pyeArrayMap</param>
+	/// <param name="rows">structs</param>
+	/// <returns>pyeArrayMap</returns>
+	static PyeArrayMap put(PyeList& list, std::string key, const std::vector<S>& rows) {
+		PyeArrayMap arrayMap = list.putArrayMap(key, getMapStruct());
+		putRows(arrayMap, rows);
+		return arrayMap;
+	}
+
+	/// <summary>
+	/// Adds a vector of structs as rows to a pyeArrayMap with the mapStruct of the schema.
+	/// </summary>
+	/// <param name="arrayMap">pyeArrayMap</param>
+	/// <param name="rows">structs</param>
+	static void putRows(PyeArrayMap& arrayMap, const std::vector<S>& rows) {
+		std::vector<unsigned char> rowData;
+		rowData.reserve(rows.size() * getSizeOfFixedFields());
+
+		for (const S& row : rows) {
+			pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t /*idxField*/) {
+				typedef typename std::decay<decltype(field)>::type::MemberType M;
+				PyeValueTypeTraits<M>::write(rowData, row.*(field.member));
+			});
+		}
+
+		arrayMap.putRows(rowData, (unsigned __int32)rows.size());
+	}
+
+	/// <summary>
+	/// Reads all rows of a pyeArrayMap into a vector of structs.
+	/// </summary>
+	/// <param name="arrayMap">pyeArrayMap</param>
+	/// <param name="rows">vector for the structs; the rows are appended</param>
+	/// <returns>false, if the mapStruct of the pyeArrayMap does not match the schema</returns>
+	static bool get(PyeArrayMap& arrayMap, std::vector<S>& rows) {
+		std::vector<pyeValueType> mapStruct = arrayMap.getMapStruct();
+		if (mapStruct.size() != countFields) {
+			return false;
+		}
+
+		bool fixedSize = true;
+		bool readable = true;
+		std::array<unsigned __int64, countFields> offsetFields;
+		unsigned __int64 stride = 0;
+
+		pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t idxField) {
+			typedef typename std::decay<decltype(field)>::type::MemberType M;
+
+			readable = readable && pyeIsReadableAs<M>(mapStruct[idxField]);
+
+			unsigned __int8 size = getSizeOfFundamentalValueType(mapStruct[idxField]);
+			fixedSize = fixedSize && size > 0;
+			offsetFields[idxField] = stride;
+			stride += size;
+		});
+
+		if (!readable) {
+			return false;
+		}
+
+		const std::vector<unsigned char>& buffer = *arrayMap.getBuffer();
+		unsigned __int32 count = arrayMap.getCount();
+		unsigned __int64 offset = arrayMap.getOffsetFirstItem();
+		size_t idxFirst = rows.size();
+		rows.resize(idxFirst + count);
+
+		for (unsigned __int32 i = 0; i < count; i++) {
+			S& row = rows[idxFirst + i];
+
+			if (fixedSize) {
+				// constant stride, every field at a fixed position in the row
+				pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t idxField) {
+					typedef typename std::decay<decltype(field)>::type::MemberType M;
+					row.*(field.member) = PyeValueTypeTraits<M>::read(buffer, offset + offsetFields[idxField], mapStruct[idxField]);
+				});
+				offset += stride;
+			}
+			else {
+				pyeForEachField(PyeSchema<S>::fields(), [&](const auto& field, size_t idxField) {
+					typedef typename std::decay<decltype(field)>::type::MemberType M;
+					row.*(field.member) = PyeValueTypeTraits<M>::read(buffer, offset, mapStruct[idxField]);
+					offset += getSizeOfValueData(buffer, offset, mapStruct[idxField]);
+				});
+			}
+		}
+
+		return true;
+	}
+
+private:
+	/// <summary>
+	/// Gets the size of all fixed-size fields of a row.
+	/// </summary>
+	static unsigned __int64 getSizeOfFixedFields() {
+		unsigned __int64 size = 0;
+		for (pyeValueType valueType : getMapStruct()) {
+			size += getSizeOfFundamentalValueType(valueType);
+		}
+		return size;
+	}
+};
@@ -0,0 +1,251 @@
+//#include "pch.h"
+
+#include <string>
+#include <cstring>
+#include <new>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "pyeKVSShared.h"
+
+
+#ifdef _WIN32
+
+bool PyeSharedMemory::create(const std::string& name, size_t size) {
+	close();
+
+	HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((unsigned __int64)size >> 32), (DWORD)size, name.c_str());
+	if (handle == NULL) {
+		return false;
+	}
+
+	void* memory = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (memory == NULL) {
+		CloseHandle(handle);
+		return false;
+	}
+
+	_name = name;
+	_handle = handle;
+	_memory = (unsigned char*)memory;
+	_size = size;
+	_owner = true;
+	return true;
+}
+
+bool PyeSharedMemory::open(const std::string& name) {
+	close();
+
+	HANDLE handle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+	if (handle == NULL) {
+		return false;
+	}
+
+	void* memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+	if (memory == NULL) {
+		CloseHandle(handle);
+		return false;
+	}
+
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(memory, &info, sizeof(info));
+
+	_name = name;
+	_handle = handle;
+	_memory = (unsigned char*)memory;
+	_size = info.RegionSize;
+	_owner = false;
+	return true;
+}
+
+void PyeSharedMemory::close() {
+	if (_memory) {
+		UnmapViewOfFile(_memory);
+		CloseHandle((HANDLE)_handle);
+	}
+
+	// the mapping is removed with its last handle
+	_handle = nullptr;
+	_memory = nullptr;
+	_size = 0;
+	_owner = false;
+}
+
+#else
+
+bool PyeSharedMemory::create(const std::string& name, size_t size) {
+	close();
+
+	shm_unlink(name.c_str());
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0) {
+		return false;
+	}
+
+	if (ftruncate(fd, (off_t)size) != 0) {
+		::close(fd);
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED) {
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	_name = name;
+	_memory = (unsigned char*)memory;
+	_size = size;
+	_owner = true;
+	return true;
+}
+
+bool PyeSharedMemory::open(const std::string& name) {
+	close();
+
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* memory = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED) {
+		return false;
+	}
+
+	_name = name;
+	_memory = (unsigned char*)memory;
+	_size = (size_t)info.st_size;
+	_owner = false;
+	return true;
+}
+
+void PyeSharedMemory::close() {
+	if (_memory) {
+		munmap(_memory, _size);
+		if (_owner) {
+			shm_unlink(_name.c_str());
+		}
+	}
+
+	_memory = nullptr;
+	_size = 0;
+	_owner = false;
+}
+
+#endif
+
+bool PyeSharedDocumentWriter::create(const std::string& name, size_t capacity) {
+	close();
+
+	// slots start at a cache line
+	capacity = (capacity + 63) / 64 * 64;
+	if (!_memory.create(name, PyeSharedHeader::offsetData + PyeSharedHeader::countSlotsMax * capacity)) {
+		return false;
+	}
+
+	_header = new (_memory.getMemory()) PyeSharedHeader();
+	_header->countSlots = PyeSharedHeader::countSlotsMax;
+	_header->capacity = capacity;
+	_header->generation.store(0, std::memory_order_relaxed);
+	for (unsigned __int32 i = 0; i < _header->countSlots; i++) {
+		_header->slots[i].sequence.store(0, std::memory_order_relaxed);
+		_header->slots[i].size = 0;
+	}
+
+	// the prefix is written last: a reader accepts the segment, when the header is complete
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(_header->prefix, "PYSH", 4);
+	return true;
+}
+
+bool PyeSharedDocumentWriter::publish(const PyeByteSpan& data) {
+	if (!_header || data.size() > _header->capacity) {
+		return false;
+	}
+
+	unsigned __int64 generation = _header->generation.load(std::memory_order_relaxed) + 1;
+	PyeSharedHeader::Slot& slot = _header->slots[generation % _header->countSlots];
+
+	// odd sequence: readers of the old document of the slot see the change
+	unsigned __int64 sequence = slot.sequence.load(std::memory_order_relaxed);
+	slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	memcpy(_memory.getMemory() + PyeSharedHeader::offsetData + (generation % _header->countSlots) * _header->capacity, data.data(), data.size());
+	slot.size = data.size();
+
+	slot.sequence.store(sequence + 2, std::memory_order_release);
+	_header->generation.store(generation, std::memory_order_release);
+	return true;
+}
+
+bool PyeSharedDocumentReader::attach(const std::string& name) {
+	detach();
+
+	if (!_memory.open(name)) {
+		return false;
+	}
+
+	const PyeSharedHeader* header = (const PyeSharedHeader*)_memory.getMemory();
+	if (_memory.getSize() < PyeSharedHeader::offsetData || memcmp(header->prefix, "PYSH", 4) != 0) {
+		_memory.close();
+		return false;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if (header->countSlots == 0 || header->countSlots > PyeSharedHeader::countSlotsMax
+		|| PyeSharedHeader::offsetData + header->countSlots * header->capacity > _memory.getSize()) {
+		_memory.close();
+		return false;
+	}
+
+	_header = header;
+	return true;
+}
+
+bool PyeSharedDocumentReader::read(PyeSharedSnapshot& snapshot) const {
+	if (!_header) {
+		return false;
+	}
+
+	for (;;) {
+		unsigned __int64 generation = _header->generation.load(std::memory_order_acquire);
+		if (generation == 0) {
+			return false;
+		}
+
+		unsigned __int32 idxSlot = (unsigned __int32)(generation % _header->countSlots);
+		const PyeSharedHeader::Slot& slot = _header->slots[idxSlot];
+
+		unsigned __int64 sequence = slot.sequence.load(std::memory_order_acquire);
+		unsigned __int64 size = slot.size;
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// the producer overwrites the slot already with a newer generation: read the newer one
+		if ((sequence & 1) != 0 || slot.sequence.load(std::memory_order_relaxed) != sequence || size > _header->capacity) {
+			continue;
+		}
+
+		snapshot.data = _memory.getMemory() + PyeSharedHeader::offsetData + idxSlot * _header->capacity;
+		snapshot.size = (size_t)size;
+		snapshot.generation = generation;
+		snapshot.sequence = sequence;
+		return true;
+	}
+}
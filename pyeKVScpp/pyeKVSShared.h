@@ -0,0 +1,226 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : exchange of pyeKVS documents between processes in shared memory
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "pyeKVS.h"
+#include "pyeKVSView.h"
+
+#pragma once
+
+/*
+* Shared memory segment
+* Name			type			size in byte	usage
+* Prefix		UInt32			4				constant: PYSH
+* CountSlots	UInt32			4				count of document slots (2)
+* Capacity		UInt64			8				size of a slot
+* Generation	UInt64			8				generation of the last published document; 0: nothing published
+* Slot0			Sequence UInt64	8				odd while the producer writes the slot
+*				Size UInt64		8				size of the document in the slot
+* Slot1			...
+* Data			bytes			64 aligned		CountSlots * Capacity bytes
+*
+* The document of generation g is in slot g % CountSlots. The producer writes a new document to the other slot,
+* so the last published document stays readable while the next one is written.
+*/
+
+/// <summary>
+/// Header of the shared memory segment
+/// </summary>
+struct PyeSharedHeader {
+	static const unsigned __int32 countSlotsMax = 2;
+
+	char prefix[4];
+	unsigned __int32 countSlots;
+	unsigned __int64 capacity;
+	std::atomic<unsigned __int64> generation;
+
+	struct Slot {
+		std::atomic<unsigned __int64> sequence;
+		unsigned __int64 size;
+	} slots[countSlotsMax];
+
+	/// <summary> Offset of the data of the first slot </summary>
+	static const size_t offsetData = 64;
+};
+
+/// <summary>
+/// Published document read by a PyeSharedDocumentReader. The bytes are read in place in the shared memory.
+/// </summary>
+struct PyeSharedSnapshot {
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+
+	/// <summary> Generation of the document </summary>
+	unsigned __int64 generation = 0;
+
+	/// <summary> Sequence of the slot, when the document was read </summary>
+	unsigned __int64 sequence = 0;
+
+	/// <summary>
+	/// Gets a read-only view of the document without a copy.
+	/// </summary>
+	PyeDocumentView getView() const {
+		return PyeDocumentView(data, size);
+	}
+};
+
+/// <summary>
+/// Mapping of a named shared memory segment (POSIX shm_open and mmap, on Windows a named file mapping).
+/// </summary>
+class PyeSharedMemory {
+	std::string _name;
+	unsigned char* _memory = nullptr;
+	size_t _size = 0;
+	bool _owner = false;
+
+	/// <summary> Handle of the file mapping (Windows) </summary>
+	void* _handle = nullptr;
+
+public:
+	PyeSharedMemory() {}
+	~PyeSharedMemory() {
+		close();
+	}
+
+	PyeSharedMemory(const PyeSharedMemory&) = delete;
+	PyeSharedMemory& operator=(const PyeSharedMemory&) = delete;
+
+	/// <summary>
+	/// Creates a segment for reading and writing. An existing segment of the name is replaced.
+	/// </summary>
+	/// <param name="name">name of the segment, e.g. "/pyeKVS.sensors"</param>
+	/// <param name="size">size of the segment</param>
+	/// <returns>false, if the segment cannot be created</returns>
+	bool create(const std::string& name, size_t size);
+
+	/// <summary>
+	/// Opens an existing segment read-only.
+	/// </summary>
+	/// <param name="name">name of the segment</param>
+	/// <returns>false, if the segment does not exist</returns>
+	bool open(const std::string& name);
+
+	/// <summary>
+	/// Unmaps the segment. A created segment is removed; mappings of other processes stay valid.
+	/// </summary>
+	void close();
+
+	unsigned char* getMemory() const {
+		return _memory;
+	}
+
+	size_t getSize() const {
+		return _size;
+	}
+};
+
+/// <summary>
+/// Producer of documents in a shared memory segment.
+/// A document is copied to the free slot and published by the increment of the generation.
+/// </summary>
+class PyeSharedDocumentWriter {
+	PyeSharedMemory _memory;
+	PyeSharedHeader* _header = nullptr;
+
+public:
+	/// <summary>
+	/// Creates the shared memory segment.
+	/// </summary>
+	/// <param name="name">name of the segment, e.g. "/pyeKVS.sensors"</param>
+	/// <param name="capacity">maximal size of a document</param>
+	/// <returns>false, if the segment cannot be created</returns>
+	bool create(const std::string& name, size_t capacity);
+
+	/// <summary>
+	/// Publishes a document.
+	/// </summary>
+	/// <param name="data">bytes of the pyeKVS document</param>
+	/// <returns>false, if the segment is not created or the document is larger than the capacity</returns>
+	bool publish(const PyeByteSpan& data);
+
+	/// <summary>
+	/// Publishes the buffer of a document.
+	/// </summary>
+	bool publish(PyeDocument& document) {
+		return publish(PyeByteSpan(*document.getBuffer()));
+	}
+
+	/// <summary>
+	/// Gets the generation of the last published document; 0, if no document is published.
+	/// </summary>
+	unsigned __int64 getGeneration() const {
+		return _header ? _header->generation.load(std::memory_order_acquire) : 0;
+	}
+
+	/// <summary>
+	/// Removes the segment.
+	/// </summary>
+	void close() {
+		_header = nullptr;
+		_memory.close();
+	}
+};
+
+/// <summary>
+/// Consumer of documents in a shared memory segment, mapped read-only.
+/// The producer reuses a slot two generations later, so a reader, which holds a snapshot for a longer time,
+/// checks the snapshot with isValid after reading (or copies the document).
+/// </summary>
+class PyeSharedDocumentReader {
+	PyeSharedMemory _memory;
+	const PyeSharedHeader* _header = nullptr;
+
+public:
+	/// <summary>
+	/// Attaches an existing segment read-only.
+	/// </summary>
+	/// <param name="name">name of the segment</param>
+	/// <returns>false, if the segment does not exist or is no pyeKVS segment</returns>
+	bool attach(const std::string& name);
+
+	/// <summary>
+	/// Gets the generation of the last published document; 0, if no document is published.
+	/// </summary>
+	unsigned __int64 getGeneration() const {
+		return _header ? _header->generation.load(std::memory_order_acquire) : 0;
+	}
+
+	/// <summary>
+	/// Reads the last published document without a copy.
+	/// </summary>
+	/// <param name="snapshot">gets the document</param>
+	/// <returns>false, if no document is published</returns>
+	bool read(PyeSharedSnapshot& snapshot) const;
+
+	/// <summary>
+	/// Checks, if the bytes of a snapshot are unchanged (the producer did not reuse the slot).
+	/// </summary>
+	bool isValid(const PyeSharedSnapshot& snapshot) const {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return _header->slots[snapshot.generation % _header->countSlots].sequence.load(std::memory_order_relaxed) == snapshot.sequence;
+	}
+
+	/// <summary>
+	/// Checks, if a newer document than the snapshot is published.
+	/// </summary>
+	bool hasNewer(const PyeSharedSnapshot& snapshot) const {
+		return getGeneration() != snapshot.generation;
+	}
+
+	void detach() {
+		_header = nullptr;
+		_memory.close();
+	}
+};
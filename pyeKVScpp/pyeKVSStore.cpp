@@ -0,0 +1,502 @@
+//#include "pch.h"
+
+#include <string>
+#include <vector>
+#include <set>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "pyeKVSStore.h"
+#include "pyeKVSView.h"
+#include "pyeKVSDirectory.h"
+
+
+bool PyeStore::open(const std::string& directory, const PyeStoreOptions& options) {
+	close();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_directory = directory;
+	_options = options;
+
+	std::vector<unsigned __int32> ids;
+	if (!readManifest(ids)) {
+		return false;
+	}
+
+	for (unsigned __int32 id : ids) {
+		if (!recoverSegment(id)) {
+			_index.clear();
+			_segments.clear();
+			return false;
+		}
+	}
+
+	// a damaged tail of the last segment is never appended to
+	if (!startSegment()) {
+		_index.clear();
+		_segments.clear();
+		return false;
+	}
+
+	_open = true;
+	return true;
+}
+
+void PyeStore::close() {
+	waitCompaction();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_writer.close();
+	_index.clear();
+	_segments.clear();
+	_idActive = 0;
+	_open = false;
+}
+
+bool PyeStore::put(const std::string& key, const PyeByteSpan& value) {
+	Entry entry;
+	PyeDocument record;
+	entry.offsetValue = encodeRecord(record, operationPut, key, value);
+	entry.sizeValue = (unsigned __int32)value.size();
+	entry.sizeRecord = (unsigned __int32)record.getBuffer()->size();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_open) {
+		return false;
+	}
+
+	if (!appendRecord(PyeByteSpan(*record.getBuffer()), entry.segment, entry.offsetRecord)) {
+		return false;
+	}
+
+	auto item = _index.find(key);
+	if (item != _index.end()) {
+		markStale(item->second);
+		item->second = entry;
+	}
+	else {
+		_index.insert(std::make_pair(key, entry));
+	}
+	_segments[entry.segment].sizeLive += entry.sizeRecord;
+
+	return true;
+}
+
+bool PyeStore::get(const std::string& key, std::vector<unsigned char>& value) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto item = _index.find(key);
+	if (item == _index.end()) {
+		return false;
+	}
+
+	const Entry& entry = item->second;
+	value.resize(entry.sizeValue);
+	return readSegment(_segments[entry.segment], entry.offsetRecord + entry.offsetValue, entry.sizeValue, value.data());
+}
+
+bool PyeStore::remove(const std::string& key) {
+	PyeDocument record;
+	encodeRecord(record, operationDelete, key, PyeByteSpan());
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto item = _index.find(key);
+	if (!_open || item == _index.end()) {
+		return false;
+	}
+
+	// the delete record is stale from the start, it only hides the older records of the key
+	unsigned __int32 segment;
+	unsigned __int64 offsetRecord;
+	if (!appendRecord(PyeByteSpan(*record.getBuffer()), segment, offsetRecord)) {
+		return false;
+	}
+
+	markStale(item->second);
+	_index.erase(item);
+	return true;
+}
+
+unsigned __int64 PyeStore::getSizeStale() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	unsigned __int64 sizeStale = 0;
+	for (const auto& segment : _segments) {
+		sizeStale += segment.second.size - segment.second.sizeLive;
+	}
+	return sizeStale;
+}
+
+bool PyeStore::compact() {
+	// a compaction of the user and a background compaction run one after the other
+	std::lock_guard<std::mutex> lockCompaction(_mutexCompaction);
+
+	std::set<unsigned __int32> closed;
+	std::vector<std::string> keys;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_open) {
+			return false;
+		}
+
+		for (const auto& segment : _segments) {
+			if (segment.first != _idActive) {
+				closed.insert(segment.first);
+			}
+		}
+		if (closed.empty()) {
+			return true;
+		}
+
+		for (const auto& item : _index) {
+			if (closed.count(item.second.segment)) {
+				keys.push_back(item.first);
+			}
+		}
+	}
+
+	// copy the live records; a key, which is put or deleted in the meantime, is not copied
+	std::vector<unsigned char> record;
+	for (const std::string& key : keys) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto item = _index.find(key);
+		if (item == _index.end() || !closed.count(item->second.segment)) {
+			continue;
+		}
+
+		Entry& entry = item->second;
+		auto segmentRecord = _segments.find(entry.segment);
+		record.resize(entry.sizeRecord);
+		if (segmentRecord == _segments.end() || !readSegment(segmentRecord->second, entry.offsetRecord, entry.sizeRecord, record.data())) {
+			return false;
+		}
+
+		unsigned __int32 segment;
+		unsigned __int64 offsetRecord;
+		if (!appendRecord(PyeByteSpan(record), segment, offsetRecord)) {
+			return false;
+		}
+
+		markStale(entry);
+		entry.segment = segment;
+		entry.offsetRecord = offsetRecord;
+		_segments[segment].sizeLive += entry.sizeRecord;
+	}
+
+	// all records older than the active segments are removed together, so the delete records are not needed anymore
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_options.flushEachWrite) {
+		_writer.flush();
+	}
+
+	std::vector<std::string> filenames;
+	for (unsigned __int32 id : closed) {
+		auto segment = _segments.find(id);
+		if (segment != _segments.end()) {
+			filenames.push_back(segment->second.filename);
+			_segments.erase(segment);
+		}
+	}
+
+	if (!writeManifest()) {
+		return false;
+	}
+
+	for (const std::string& filename : filenames) {
+		std::remove(filename.c_str());
+	}
+	return true;
+}
+
+void PyeStore::startCompaction() {
+	if (_compacting.exchange(true)) {
+		return;
+	}
+
+	if (_compaction.joinable()) {
+		_compaction.join();
+	}
+
+	_compaction = std::thread([this]() {
+		compact();
+		_compacting.store(false);
+	});
+}
+
+void PyeStore::waitCompaction() {
+	if (_compaction.joinable()) {
+		_compaction.join();
+	}
+}
+
+std::string PyeStore::getFilenameSegment(unsigned __int32 id) const {
+	char name[32];
+	snprintf(name, sizeof(name), "/%08u.pyeseg", id);
+	return _directory + name;
+}
+
+bool PyeStore::readManifest(std::vector<unsigned __int32>& ids) {
+	ids.clear();
+
+	std::ifstream input(getFilenameManifest(), std::ios::binary);
+	if (!input) {
+		// new store
+		return true;
+	}
+
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	unsigned __int64 sizeData;
+	if (buffer.size() < 26 /*header and root list*/ || memcmp(buffer.data(), "PYES", 4) != 0
+		|| (ReadFromVector(sizeData, buffer, 8), sizeData + 16 != buffer.size())) {
+		return false;
+	}
+
+	PyeDocumentView manifest(&buffer);
+
+	const unsigned char* data;
+	unsigned __int32 count;
+	pyeValueType arrayType;
+	// the count is read from the file: the ids must be inside the manifest
+	if (!manifest.getRoot().getArrayData("segments", data, count, arrayType) || arrayType != pyeValueType::pyeUInt32
+		|| data > buffer.data() + buffer.size() || (unsigned __int64)count * sizeof(unsigned __int32) > (unsigned __int64)(buffer.data() + buffer.size() - data)) {
+		return false;
+	}
+
+	ids.resize(count);
+	memcpy(ids.data(), data, count * sizeof(unsigned __int32));
+	return true;
+}
+
+bool PyeStore::writeManifest() {
+	PyeDocument manifest;
+	PyeArray segments = manifest.getRoot().putArray("segments", pyeValueType::pyeUInt32);
+	for (const auto& segment : _segments) {
+		segments.putUInt32(segment.first);
+	}
+
+	// the new manifest is synced, before it replaces the old one with a rename: a crash leaves the old or the new manifest
+	std::string filename = getFilenameManifest();
+	std::string filenameNew = filename + ".new";
+	return writeFile(filenameNew, *manifest.getBuffer()) && replaceFile(filenameNew, filename);
+}
+
+bool PyeStore::recoverSegment(unsigned __int32 id) {
+	Segment& segment = _segments[id];
+	segment.filename = getFilenameSegment(id);
+
+	std::ifstream input(segment.filename, std::ios::binary);
+	if (!input) {
+		return false;
+	}
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	segment.reader.reset(new std::ifstream(segment.filename, std::ios::binary));
+	segment.size = buffer.size();
+
+	unsigned __int64 offset = 0;
+	while (offset + 16 <= buffer.size()) {
+		unsigned __int64 sizeData;
+		ReadFromVector(sizeData, buffer, offset + 8);
+
+		if (memcmp(&buffer[offset], "PYES", 4) != 0 || sizeData > buffer.size() - offset - 16) {
+			break;
+		}
+
+		unsigned __int32 sizeRecord = (unsigned __int32)(16 + sizeData);
+		Entry entry = { id, offset, sizeRecord, 0, 0 };
+
+		Operation operation;
+		std::string key;
+		if (!decodeRecord(PyeByteSpan(&buffer[offset], sizeRecord), operation, key, entry.offsetValue, entry.sizeValue)) {
+			break;
+		}
+
+		auto item = _index.find(key);
+		if (item != _index.end()) {
+			markStale(item->second);
+			if (operation == operationDelete) {
+				_index.erase(item);
+			}
+			else {
+				item->second = entry;
+			}
+		}
+		else if (operation == operationPut) {
+			_index.insert(std::make_pair(key, entry));
+		}
+
+		if (operation == operationPut) {
+			segment.sizeLive += sizeRecord;
+		}
+
+		offset += sizeRecord;
+	}
+
+	return true;
+}
+
+bool PyeStore::startSegment() {
+	_writer.close();
+
+	// a file of the id may be left by a crash before the manifest was written; it is skipped, not truncated
+	unsigned __int32 id = _segments.empty() ? 1 : _segments.rbegin()->first + 1;
+	while (std::ifstream(getFilenameSegment(id), std::ios::binary)) {
+		id++;
+	}
+
+	Segment& segment = _segments[id];
+	segment.filename = getFilenameSegment(id);
+
+	_writer.open(segment.filename, std::ios::binary | std::ios::app);
+	segment.reader.reset(new std::ifstream(segment.filename, std::ios::binary));
+	if (!_writer || !*segment.reader || !writeManifest()) {
+		_segments.erase(id);
+		return false;
+	}
+
+	_idActive = id;
+	return true;
+}
+
+unsigned __int32 PyeStore::encodeRecord(PyeDocument& record, Operation operation, const std::string& key, const PyeByteSpan& value) {
+	PyeList& root = record.getRoot();
+	root.putUInt8(operation, "o");
+	root.putStringL(key, "k");
+
+	unsigned __int32 offsetValue = 0;
+	if (operation == operationPut) {
+		offsetValue = (unsigned __int32)(record.getBuffer()->size() + 1 /*key size*/ + 1 /*key "v"*/ + 1 /*pye value type*/ + 4 /*memory size*/);
+		root.putMemory(std::vector<unsigned char>(value.begin(), value.end()), "v");
+	}
+	root.putUInt64(pyeHashKey(value.data(), value.size(), pyeHashKey(key)), "h");
+
+	return offsetValue;
+}
+
+bool PyeStore::decodeRecord(const PyeByteSpan& record, Operation& operation, std::string& key, unsigned __int32& offsetValue, unsigned __int32& sizeValue) {
+	// the root list must fill the record, before the items are decoded
+	unsigned __int32 sizeList;
+	if (record.size() < 26 /*header and root list*/ || record[16] != 0 /*root name*/ || record[17] != pyeValueType::pyeList
+		|| (ReadFromVector(sizeList, record, 18), 26 + (unsigned __int64)sizeList != record.size())) {
+		return false;
+	}
+
+	PyeDocumentView view(record.data(), record.size());
+	const PyeListView& root = view.getRoot();
+
+	operation = (Operation)root.getUInt8("o");
+	key = root.getStringL("k");
+
+	const unsigned char* data = nullptr;
+	unsigned __int32 size = 0;
+	if (operation == operationPut) {
+		if (!root.getMemoryData("v", data, size)) {
+			return false;
+		}
+	}
+	else if (operation != operationDelete) {
+		return false;
+	}
+
+	if (root.getUInt64("h") != pyeHashKey(data, size, pyeHashKey(key))) {
+		return false;
+	}
+
+	offsetValue = data ? (unsigned __int32)(data - record.data()) : 0;
+	sizeValue = size;
+	return true;
+}
+
+bool PyeStore::appendRecord(const PyeByteSpan& record, unsigned __int32& segment, unsigned __int64& offsetRecord) {
+	Segment* active = &_segments[_idActive];
+	if (active->size > 0 && active->size + record.size() > _options.sizeSegment) {
+		if (!startSegment()) {
+			return false;
+		}
+		active = &_segments[_idActive];
+
+		if (_options.ratioStaleCompaction > 0) {
+			unsigned __int64 size = 0;
+			unsigned __int64 sizeLive = 0;
+			for (const auto& item : _segments) {
+				size += item.second.size;
+				sizeLive += item.second.sizeLive;
+			}
+			if (size > 0 && (double)(size - sizeLive) / size >= _options.ratioStaleCompaction) {
+				startCompaction();
+			}
+		}
+	}
+
+	_writer.write((const char*)record.data(), record.size());
+	if (_options.flushEachWrite) {
+		_writer.flush();
+	}
+	if (!_writer) {
+		return false;
+	}
+
+	segment = _idActive;
+	offsetRecord = active->size;
+	active->size += record.size();
+	return true;
+}
+
+void PyeStore::markStale(const Entry& entry) {
+	auto segment = _segments.find(entry.segment);
+	if (segment != _segments.end()) {
+		segment->second.sizeLive -= entry.sizeRecord;
+	}
+}
+
+bool PyeStore::readSegment(Segment& segment, unsigned __int64 offset, size_t size, unsigned char* data) {
+	if (segment.reader == nullptr) {
+		return false;
+	}
+
+	// the records of the active segment are only in the file after a flush
+	if (!_options.flushEachWrite && &segment == &_segments[_idActive]) {
+		_writer.flush();
+	}
+
+	std::ifstream& reader = *segment.reader;
+	reader.clear();
+	reader.seekg((std::streamoff)offset);
+	reader.read((char*)data, size);
+	return (size_t)reader.gcount() == size;
+}
+
+bool PyeStore::writeFile(const std::string& filename, const std::vector<unsigned char>& data) {
+	FILE* file = fopen(filename.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+
+	bool written = fwrite(data.data(), 1, data.size(), file) == data.size() && fflush(file) == 0 && syncFile(file);
+	return fclose(file) == 0 && written;
+}
+
+bool PyeStore::replaceFile(const std::string& filenameFrom, const std::string& filenameTo) {
+#ifdef _WIN32
+	return MoveFileExA(filenameFrom.c_str(), filenameTo.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return std::rename(filenameFrom.c_str(), filenameTo.c_str()) == 0;
+#endif
+}
+
+bool PyeStore::syncFile(FILE* file) {
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
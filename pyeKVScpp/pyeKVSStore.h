@@ -0,0 +1,248 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : append-only log-structured key-value store of pyeKVS records
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <fstream>
+
+#include "pyeKVS.h"
+
+#pragma once
+
+/*
+* Store directory
+* store.pye				manifest: pyeKVS document with the ids of the segments ("segments", pyeArray of UInt32)
+* 00000001.pyeseg		segment: records appended one after the other
+*
+* Record: a pyeKVS document (16-byte header gives the size of the record) with the root list
+* Key	type			usage
+* o		UInt8			operation: 1 put, 2 delete
+* k		StringUTF8L		key
+* v		Memory			value (put only)
+* h		UInt64			check sum of key and value (pyeHashKey)
+*
+* The segments are read in the order of the manifest; a later record of a key replaces an earlier one.
+* The scan of a segment stops at the first incomplete or damaged record (e.g. a write cut off by a crash).
+*/
+
+/// <summary>
+/// Options of a PyeStore
+/// </summary>
+struct PyeStoreOptions {
+	/// <summary> Size of a segment, after which a new segment is started </summary>
+	unsigned __int64 sizeSegment = 64ULL << 20;
+
+	/// <summary> Share of stale bytes in the closed segments, which starts a background compaction; 0: no automatic compaction </summary>
+	double ratioStaleCompaction = 0.5;
+
+	/// <summary> Flushes every put and delete to the operating system </summary>
+	bool flushEachWrite = true;
+};
+
+/// <summary>
+/// Embedded key-value store with append-only segment files of pyeKVS records (log-structured, like Bitcask).
+/// Puts and deletes are appended to the active segment; an in-memory hash index holds the position of the value
+/// of every key, so a get is one read. Replaced and deleted records are stale; the compaction copies the live
+/// records of the closed segments to the active segment and removes the closed segments.
+/// On open the index is recovered by a scan of the record headers of all segments.
+/// All methods are thread safe; the compaction can run in a background thread.
+/// </summary>
+class PyeStore {
+public:
+	PyeStore() {}
+	~PyeStore() {
+		close();
+	}
+
+	PyeStore(const PyeStore&) = delete;
+	PyeStore& operator=(const PyeStore&) = delete;
+
+	/// <summary>
+	/// Opens the store in an existing directory and recovers the index. A new active segment is started.
+	/// </summary>
+	/// <param name="directory">directory of the store</param>
+	/// <param name="options">options</param>
+	/// <returns>false, if a segment or the manifest cannot be read or written</returns>
+	bool open(const std::string& directory, const PyeStoreOptions& options = PyeStoreOptions());
+
+	/// <summary>
+	/// Waits for a running compaction and closes the segment files.
+	/// </summary>
+	void close();
+
+	/// <summary>
+	/// Puts the value of a key.
+	/// </summary>
+	/// <param name="key">key</param>
+	/// <param name="value">value, e.g. the bytes of a pyeKVS document</param>
+	/// <returns>false, if the store is not open or the record cannot be written</returns>
+	bool put(const std::string& key, const PyeByteSpan& value);
+
+	bool put(const std::string& key, PyeDocument& document) {
+		return put(key, PyeByteSpan(*document.getBuffer()));
+	}
+
+	/// <summary>
+	/// Gets the value of a key.
+	/// </summary>
+	/// <param name="key">key</param>
+	/// <param name="value">gets the value</param>
+	/// <returns>false, if the key does not exist</returns>
+	bool get(const std::string& key, std::vector<unsigned char>& value);
+
+	/// <summary>
+	/// Deletes a key.
+	/// </summary>
+	/// <param name="key">key</param>
+	/// <returns>false, if the key does not exist</returns>
+	bool remove(const std::string& key);
+
+	bool contains(const std::string& key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _index.find(key) != _index.end();
+	}
+
+	size_t getCount() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _index.size();
+	}
+
+	size_t getCountSegments() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _segments.size();
+	}
+
+	/// <summary>
+	/// Gets the count of stale bytes in all segments.
+	/// </summary>
+	unsigned __int64 getSizeStale();
+
+	/// <summary>
+	/// Copies the live records of the closed segments to the active segment and removes the closed segments.
+	/// Puts, gets and deletes continue during the compaction; a running background compaction is waited for.
+	/// </summary>
+	/// <returns>false, if a record cannot be copied or the manifest cannot be written</returns>
+	bool compact();
+
+	/// <summary>
+	/// Starts the compaction in a background thread, if no compaction is running.
+	/// </summary>
+	void startCompaction();
+
+	/// <summary>
+	/// Waits for the end of a background compaction.
+	/// </summary>
+	void waitCompaction();
+
+private:
+	/// <summary> Position of the value of a key </summary>
+	struct Entry {
+		unsigned __int32 segment;
+		unsigned __int64 offsetRecord;
+		unsigned __int32 sizeRecord;
+		unsigned __int32 offsetValue;	// relative to the record
+		unsigned __int32 sizeValue;
+	};
+
+	struct Segment {
+		std::string filename;
+		std::unique_ptr<std::ifstream> reader;
+		unsigned __int64 size = 0;
+		unsigned __int64 sizeLive = 0;
+	};
+
+	enum Operation : unsigned __int8 {
+		operationPut = 1,
+		operationDelete = 2
+	};
+
+	std::mutex _mutex;
+	std::string _directory;
+	PyeStoreOptions _options;
+	bool _open = false;
+
+	std::unordered_map<std::string, Entry> _index;
+	std::map<unsigned __int32, Segment> _segments;
+
+	unsigned __int32 _idActive = 0;
+	std::ofstream _writer;
+
+	std::thread _compaction;
+	std::atomic<bool> _compacting{ false };
+
+	/// <summary> Held during a compaction, so compactions do not overlap </summary>
+	std::mutex _mutexCompaction;
+
+	std::string getFilenameSegment(unsigned __int32 id) const;
+
+	std::string getFilenameManifest() const {
+		return _directory + "/store.pye";
+	}
+
+	bool readManifest(std::vector<unsigned __int32>& ids);
+
+	/// <summary>
+	/// Writes the list of segments to a new manifest, which replaces the old one atomically.
+	/// </summary>
+	bool writeManifest();
+
+	/// <summary>
+	/// Scans the records of a segment and updates the index.
+	/// </summary>
+	bool recoverSegment(unsigned __int32 id);
+
+	/// <summary>
+	/// Starts a new active segment in a new file; an existing file is never truncated.
+	/// </summary>
+	bool startSegment();
+
+	/// <summary>
+	/// Writes a file and syncs it to the disk.
+	/// </summary>
+	static bool writeFile(const std::string& filename, const std::vector<unsigned char>& data);
+
+	/// <summary>
+	/// Replaces a file by another one with a rename.
+	/// </summary>
+	static bool replaceFile(const std::string& filenameFrom, const std::string& filenameTo);
+
+	static bool syncFile(FILE* file);
+
+	/// <summary>
+	/// Encodes a record.
+	/// </summary>
+	/// <returns>offset of the value in the record</returns>
+	static unsigned __int32 encodeRecord(PyeDocument& record, Operation operation, const std::string& key, const PyeByteSpan& value);
+
+	/// <summary>
+	/// Decodes a record and checks its check sum.
+	/// </summary>
+	static bool decodeRecord(const PyeByteSpan& record, Operation& operation, std::string& key, unsigned __int32& offsetValue, unsigned __int32& sizeValue);
+
+	/// <summary>
+	/// Appends a record to the active segment; the caller holds the mutex.
+	/// </summary>
+	bool appendRecord(const PyeByteSpan& record, unsigned __int32& segment, unsigned __int64& offsetRecord);
+
+	/// <summary>
+	/// Marks the record of an entry as stale; the caller holds the mutex.
+	/// </summary>
+	void markStale(const Entry& entry);
+
+	bool readSegment(Segment& segment, unsigned __int64 offset, size_t size, unsigned char* data);
+};
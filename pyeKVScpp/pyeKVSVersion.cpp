@@ -0,0 +1,107 @@
+//#include "pch.h"
+
+#include <vector>
+#include <chrono>
+
+#include "pyeKVSVersion.h"
+#include "pyeKVSDiff.h"
+
+
+unsigned __int64 PyeVersionedDocument::publish(PyeDocument& document, unsigned __int64 numberBase, PyeWriteAheadLog* log) {
+	std::lock_guard<std::mutex> lock(_mutexWriter);
+
+	if (_current->_number != numberBase) {
+		return 0;
+	}
+
+	// the change to the current version is logged as patch, so the checkpoints and the recovery see it like an update
+	unsigned __int64 sequence = _current->_sequence;
+	if (log != nullptr) {
+		PyeDocument documentBase(&_current->_buffer);
+		PyeDocument patch = PyeDiff::diff(documentBase, document);
+		sequence = log->commit(patch);
+		if (sequence == 0) {
+			return 0;
+		}
+	}
+
+	std::shared_ptr<PyeDocumentVersion> version = makeVersion(document, numberBase + 1, sequence);
+	std::atomic_store(&_current, version);
+	return version->_number;
+}
+
+unsigned __int64 PyeVersionedDocument::update(PyeUpdate& update, PyeWriteAheadLog* log) {
+	std::lock_guard<std::mutex> lock(_mutexWriter);
+
+	// the order of the log is the order of the versions
+	unsigned __int64 sequence = _current->_sequence;
+	if (log != nullptr) {
+		sequence = log->commit(update);
+		if (sequence == 0) {
+			return 0;
+		}
+	}
+
+	// the current version is only read; readers go on with it during the patch
+	PyeDocument documentBase(&_current->_buffer);
+	PyeDocument patch = update.encode();
+	PyeDocument document = PyeDiff::patch(documentBase, patch);
+
+	std::shared_ptr<PyeDocumentVersion> version = makeVersion(document, _current->_number + 1, sequence);
+	std::atomic_store(&_current, version);
+	return version->_number;
+}
+
+unsigned __int64 PyeVersionedDocument::restore(PyeDocument& document, PyeWriteAheadLog& log) {
+	std::lock_guard<std::mutex> lock(_mutexWriter);
+
+	std::shared_ptr<PyeDocumentVersion> version = makeVersion(document, _current->_number + 1, log.getSequence());
+	std::atomic_store(&_current, version);
+	return version->_number;
+}
+
+bool PyeVersionedDocument::checkpoint(PyeWriteAheadLog& log) {
+	std::shared_ptr<PyeDocumentVersion> version = std::atomic_load(&_current);
+
+	PyeDocument document(&version->_buffer);
+	return log.checkpoint(document, version->_sequence);
+}
+
+void PyeVersionedDocument::startCheckpoints(PyeWriteAheadLog& log, unsigned __int32 interval) {
+	stopCheckpoints();
+
+	_stopping = false;
+	_checkpoints = std::thread([this, &log, interval]() {
+		unsigned __int64 sequence = pin()->getSequence();
+
+		std::unique_lock<std::mutex> lock(_mutexCheckpoints);
+		while (!_conditionCheckpoints.wait_for(lock, std::chrono::milliseconds(interval), [this]() { return _stopping; })) {
+			PyeVersionPin version = pin();
+			if (version->getSequence() != sequence && checkpoint(log)) {
+				sequence = version->getSequence();
+			}
+		}
+	});
+}
+
+void PyeVersionedDocument::stopCheckpoints() {
+	{
+		std::lock_guard<std::mutex> lock(_mutexCheckpoints);
+		_stopping = true;
+	}
+	_conditionCheckpoints.notify_all();
+
+	if (_checkpoints.joinable()) {
+		_checkpoints.join();
+	}
+}
+
+std::shared_ptr<PyeDocumentVersion> PyeVersionedDocument::makeVersion(PyeDocument& document, unsigned __int64 number, unsigned __int64 sequence) {
+	std::shared_ptr<PyeDocumentVersion> version = std::make_shared<PyeDocumentVersion>();
+	version->_number = number;
+	version->_sequence = sequence;
+	version->_buffer.swap(*document.getBuffer());
+
+	document.reset();
+	return version;
+}
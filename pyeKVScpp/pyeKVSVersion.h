@@ -0,0 +1,176 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : copy-on-write versions of pyeKVS documents with atomic publish
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "pyeKVS.h"
+#include "pyeKVSView.h"
+#include "pyeKVSLog.h"
+
+#pragma once
+
+/// <summary>
+/// Immutable version of a versioned pyeKVS document.
+/// A reader pins a version by holding its shared pointer and reads it without a lock;
+/// the version is freed, when the last reader releases it.
+/// </summary>
+class PyeDocumentVersion {
+	friend class PyeVersionedDocument;
+
+	unsigned __int64 _number = 0;
+	unsigned __int64 _sequence = 0;
+	std::vector<unsigned char> _buffer;
+
+public:
+	/// <summary>
+	/// Gets the number of the version; every publish increments the number.
+	/// </summary>
+	unsigned __int64 getNumber() const {
+		return _number;
+	}
+
+	/// <summary>
+	/// Gets the sequence number of the last update in the write-ahead log; 0 without a log.
+	/// </summary>
+	unsigned __int64 getSequence() const {
+		return _sequence;
+	}
+
+	const std::vector<unsigned char>& getBuffer() const {
+		return _buffer;
+	}
+
+	/// <summary>
+	/// Gets a read-only view of the version without a copy.
+	/// </summary>
+	PyeDocumentView getView() const {
+		return PyeDocumentView(&_buffer);
+	}
+
+	/// <summary>
+	/// Gets a copy of the version, which a writer changes and publishes as new version.
+	/// </summary>
+	PyeDocument copy() const {
+		PyeDocument document;
+		document.getBuffer()->assign(_buffer.begin(), _buffer.end());
+		document.getRoot().decode();
+		return document;
+	}
+};
+
+/// <summary> Pinned version of a versioned pyeKVS document </summary>
+typedef std::shared_ptr<const PyeDocumentVersion> PyeVersionPin;
+
+/// <summary>
+/// Versioned pyeKVS document with copy-on-write versions, e.g. a shared configuration.
+/// Readers pin the current version and never see a half-written state; writers build a new version
+/// from the current one and publish it with an atomic exchange of the shared pointer.
+/// A reader keeps its pinned version until it releases it, independent of later publishes.
+/// Writers are serialized; readers do not wait for writers.
+/// </summary>
+class PyeVersionedDocument {
+public:
+	PyeVersionedDocument() {
+		PyeDocument document;
+		_current = makeVersion(document, 0, 0);
+	}
+
+	~PyeVersionedDocument() {
+		stopCheckpoints();
+	}
+
+	PyeVersionedDocument(const PyeVersionedDocument&) = delete;
+	PyeVersionedDocument& operator=(const PyeVersionedDocument&) = delete;
+
+	/// <summary>
+	/// Pins the current version.
+	/// </summary>
+	/// <returns>current version; it is released with the last copy of the pointer</returns>
+	PyeVersionPin pin() const {
+		return std::atomic_load(&_current);
+	}
+
+	/// <summary>
+	/// Gets the number of the current version.
+	/// </summary>
+	unsigned __int64 getNumber() const {
+		return pin()->getNumber();
+	}
+
+	/// <summary>
+	/// Publishes a document as new version. The bytes of the document are moved to the version
+	/// and the document is empty afterwards.
+	/// With a write-ahead log the difference to the base version is committed as patch before it is published;
+	/// a document, which is updated with a log, loses a publish without the log on a crash.
+	/// </summary>
+	/// <param name="document">new document, e.g. a changed copy of the base version</param>
+	/// <param name="numberBase">number of the version, from which the document was built</param>
+	/// <param name="log">write-ahead log of the updates; nullptr: without log</param>
+	/// <returns>number of the new version; 0, if another version was published after the base version or the commit to the log failed</returns>
+	unsigned __int64 publish(PyeDocument& document, unsigned __int64 numberBase, PyeWriteAheadLog* log = nullptr);
+
+	/// <summary>
+	/// Applies an update to the current version and publishes the result as new version.
+	/// The update is committed to the write-ahead log before it is published.
+	/// Unchanged objects and sub-lists are copied as byte blocks without decoding.
+	/// </summary>
+	/// <param name="update">update</param>
+	/// <param name="log">write-ahead log of the updates; nullptr: without log</param>
+	/// <returns>number of the new version; 0, if the commit to the log failed</returns>
+	unsigned __int64 update(PyeUpdate& update, PyeWriteAheadLog* log = nullptr);
+
+	/// <summary>
+	/// Replaces the current version with a document recovered from a write-ahead log.
+	/// </summary>
+	/// <param name="document">recovered document; the bytes are moved to the version</param>
+	/// <param name="log">opened write-ahead log</param>
+	/// <returns>number of the new version</returns>
+	unsigned __int64 restore(PyeDocument& document, PyeWriteAheadLog& log);
+
+	/// <summary>
+	/// Writes the current version as snapshot of a write-ahead log. Readers and writers continue during the write.
+	/// </summary>
+	/// <param name="log">write-ahead log of the updates</param>
+	/// <returns>false, if the snapshot cannot be written</returns>
+	bool checkpoint(PyeWriteAheadLog& log);
+
+	/// <summary>
+	/// Starts a background thread, which writes a snapshot in an interval, if the document was updated.
+	/// </summary>
+	/// <param name="log">write-ahead log of the updates; it must stay open until stopCheckpoints</param>
+	/// <param name="interval">interval in milliseconds</param>
+	void startCheckpoints(PyeWriteAheadLog& log, unsigned __int32 interval);
+
+	/// <summary>
+	/// Stops the background thread of the snapshots.
+	/// </summary>
+	void stopCheckpoints();
+
+private:
+	/// <summary> Current version; exchanged with std::atomic_store </summary>
+	std::shared_ptr<PyeDocumentVersion> _current;
+
+	/// <summary> Serializes the writers </summary>
+	std::mutex _mutexWriter;
+
+	std::thread _checkpoints;
+	std::mutex _mutexCheckpoints;
+	std::condition_variable _conditionCheckpoints;
+	bool _stopping = false;
+
+	static std::shared_ptr<PyeDocumentVersion> makeVersion(PyeDocument& document, unsigned __int64 number, unsigned __int64 sequence);
+};
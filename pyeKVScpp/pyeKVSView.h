@@ -0,0 +1,618 @@
+/* ====================================================================================
+* Projekt: PYEKVS(Pye - Key - Value - Storage)
+* Description : read-only views of pyeKVS documents
+* Compiler : C++14 ISO
+* Author : Dr. Sylvio Schneider
+* License : MIT
+* ====================================================================================
+* Copyright(c) 2021 Dr. Sylvio Schneider
+* see pyeKVS.h for the full license text
+* ====================================================================================
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+#include "pyeKVS.h"
+#include "pyeKVSIndex.h"
+#include "pyeKVSDirectory.h"
+#include "pyeKVSPerfectHash.h"
+#include "pyeKVSCache.h"
+
+#pragma once
+
+/// <summary>
+/// Read-only view of a encoded pyeList.
+/// The index of the keys is built once in the constructor, all other methods are const
+/// and never change the view or the byte stream. A view can be shared by several threads
+/// without locks as long as the byte stream is not changed.
+/// A key which is not in the list or has another pye value type returns the given default value, the getters of the containers return false.
+/// With a PyeDocumentIndex the views of the lists use the prebuilt index and decode nothing.
+/// A list with a key directory (PyeKeyDirectory) or a minimal perfect hash (PyePerfectHash) is not decoded,
+/// the keys are looked up in the directory or the hash.
+/// The view reads a std::vector or a byte span (pointer and length) in any memory without a copy;
+/// the getters of pyeArray, pyeArrayMap and pyeColumnMap objects need a std::vector.
+/// With a PyeContainerCache the decoded indexes of the lists and pyeArrayMaps are taken from the cache.
+/// </summary>
+class PyeListView {
+	/// <summary> Bytes of the pyeKVS byte stream </summary>
+	PyeByteSpan _data;
+
+	/// <summary> Pointer to the byte buffer; nullptr, if the view reads a byte span </summary>
+	const std::vector<unsigned char>* _buffer = nullptr;
+
+	/// <summary> Offset of this list in the pyeKVS byte stream </summary>
+	unsigned __int64 _offsetObject = 0;
+
+	/// <summary> Index of key and offset of the pyeKVS objects of this list </summary>
+	std::shared_ptr<const PyeDocumentIndex::ItemIdx> _mapItemIdx = std::make_shared<PyeDocumentIndex::ItemIdx>();
+
+	/// <summary> Optional prebuilt index of all lists of the document </summary>
+	std::shared_ptr<const PyeDocumentIndex> _documentIndex;
+
+	/// <summary> Optional cache of the decoded containers of the byte stream </summary>
+	std::shared_ptr<PyeContainerCache> _cache;
+
+	/// <summary> True, if the keys are looked up in the key directory of the list </summary>
+	bool _keyDirectory = false;
+
+	/// <summary> True, if the keys are looked up in the minimal perfect hash of the list </summary>
+	bool _perfectHash = false;
+
+	/// <summary> Index of the items read once from the key directory or the minimal perfect hash </summary>
+	struct ItemIdxOnce {
+		std::once_flag built;
+		PyeDocumentIndex::ItemIdx itemIdx;
+	};
+
+	/// <summary> Index of the items of a list with key directory or minimal perfect hash, built on the first call of getItemIdx </summary>
+	std::shared_ptr<ItemIdxOnce> _itemIdxOnce;
+
+public:
+	PyeListView() {}
+
+	/// <summary>
+	/// Constructor of a read-only pyeList
+	/// </summary>
+	/// <param name="buffer">pointer to the byte stream</param>
+	/// <param name="offsetObject">offset of the pyeList object in the byte stream</param>
+	/// <param name="documentIndex">optional prebuilt index of the lists of the document</param>
+	/// <param name="cache">optional cache of the decoded containers of the byte stream</param>
+	PyeListView(const std::vector<unsigned char>* buffer, unsigned __int64 offsetObject,
+		std::shared_ptr<const PyeDocumentIndex> documentIndex = nullptr, std::shared_ptr<PyeContainerCache> cache = nullptr)
+		: PyeListView(PyeByteSpan(*buffer), buffer, offsetObject, documentIndex, cache) {}
+
+	/// <summary>
+	/// Constructor of a read-only pyeList of a byte span, e.g. a network buffer or shared memory.
+	/// The bytes are read in place; pyeArray, pyeArrayMap and pyeColumnMap objects need a std::vector,
+	/// so getArray, getArrayMap and getColumnMap are not available, the data of an array is read with getArrayData.
+	/// </summary>
+	/// <param name="data">bytes of the byte stream</param>
+	/// <param name="offsetObject">offset of the pyeList object in the byte stream</param>
+	/// <param name="documentIndex">optional prebuilt index of the lists of the document</param>
+	/// <param name="cache">optional cache of the decoded containers of the byte stream</param>
+	PyeListView(const PyeByteSpan& data, unsigned __int64 offsetObject,
+		std::shared_ptr<const PyeDocumentIndex> documentIndex = nullptr, std::shared_ptr<PyeContainerCache> cache = nullptr)
+		: PyeListView(data, nullptr, offsetObject, documentIndex, cache) {}
+
+	/// <summary>
+	/// Gets the pointer to the byte buffer.
+	/// </summary>
+	/// <returns>buffer; nullptr, if the view reads a byte span</returns>
+	const std::vector<unsigned char>* getBuffer() const {
+		return _buffer;
+	}
+
+	/// <summary>
+	/// Gets the bytes of the byte stream.
+	/// </summary>
+	const PyeByteSpan& getData() const {
+		return _data;
+	}
+
+	unsigned __int64 getOffsetObject() const {
+		return _offsetObject;
+	}
+
+	/// <summary>
+	/// Get the offset (index position) of the pye value type of the list.
+	/// </summary>
+	/// <returns>offset</returns>
+	unsigned __int64 getOffsetValue() const {
+		return _offsetObject + 1 /*information size of key*/ + _data[_offsetObject];
+	}
+
+	/// <summary>
+	/// Gets the size (amount of bytes) of the list.
+	/// </summary>
+	/// <returns>size of the list</returns>
+	unsigned __int32 getSize() const {
+		unsigned __int32 listSize;
+		ReadFromVector(listSize, _data, getOffsetValue() + 1 /*information pyeValueType(1 byte)*/);
+		return listSize;
+	}
+
+	/// <summary>
+	/// Gets the count of items of the list.
+	/// </summary>
+	/// <returns>count of items</returns>
+	unsigned __int32 getCount() const {
+		unsigned __int32 listCount;
+		ReadFromVector(listCount, _data, getOffsetValue() + 5 /*information pyeValueType(1 Byte) + listSize(4 byte)*/);
+		return listCount;
+	}
+
+	/// <summary>
+	/// Gets the index of the items of the list.
+	/// A list with key directory or minimal perfect hash reads the index once from the directory or the hash
+	/// on the first call, the lookups of the keys do not need it.
+	/// </summary>
+	/// <returns>map of key and offset of the pyeKVS object in the byte stream</returns>
+	const PyeItemIdx& getItemIdx() const {
+		if (!_itemIdxOnce) {
+			return *_mapItemIdx;
+		}
+
+		ItemIdxOnce& itemIdxOnce = *_itemIdxOnce;
+		std::call_once(itemIdxOnce.built, [&]() {
+			if (_perfectHash) {
+				PyePerfectHash::getItemIdx(_data.data(), _data.size(), _offsetObject, itemIdxOnce.itemIdx);
+			}
+			else {
+				PyeKeyDirectory::getItemIdx(_data.data(), _data.size(), _offsetObject, itemIdxOnce.itemIdx);
+			}
+		});
+		return itemIdxOnce.itemIdx;
+	}
+
+	/// <summary>
+	/// Checks if the list contains a key.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <returns>true, if the key exists</returns>
+	bool hasKey(const std::string& key) const {
+		unsigned __int64 offsetObject;
+		return findItem(key, offsetObject);
+	}
+
+	/// <summary>
+	/// Gets the pye value type of a key.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <returns>pyeValueType; pyeUnknown if the key does not exist</returns>
+	pyeValueType getValueType(const std::string& key) const {
+		unsigned __int64 offsetValue;
+		if (!findValue(key, offsetValue)) {
+			return pyeValueType::pyeUnknown;
+		}
+
+		pyeValueType valueType;
+		ReadFromVector(valueType, _data, offsetValue - 1 /*pye value type*/);
+		return valueType;
+	}
+
+	/// <summary>
+	/// Gets a bool value. pyeBool is true, pyeZero is false.
+	/// </summary>
+	bool getBool(const std::string& key, bool defaultValue = false) const {
+		switch (getValueType(key)) {
+		case pyeValueType::pyeBool: return true;
+		case pyeValueType::pyeZero: return false;
+		default: return defaultValue;
+		}
+	}
+
+	__int8 getInt8(const std::string& key, __int8 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	__int16 getInt16(const std::string& key, __int16 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	__int32 getInt32(const std::string& key, __int32 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	__int64 getInt64(const std::string& key, __int64 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	unsigned __int8 getUInt8(const std::string& key, unsigned __int8 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	unsigned __int16 getUInt16(const std::string& key, unsigned __int16 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	unsigned __int32 getUInt32(const std::string& key, unsigned __int32 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	unsigned __int64 getUInt64(const std::string& key, unsigned __int64 defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	float getFloat(const std::string& key, float defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	double getDouble(const std::string& key, double defaultValue = 0) const {
+		return readValue(key, defaultValue);
+	}
+
+	int128 getInt128(const std::string& key) const {
+		return readValue(key, int128());
+	}
+
+	uInt128 getUInt128(const std::string& key) const {
+		return readValue(key, uInt128());
+	}
+
+	float128 getFloat128(const std::string& key) const {
+		return readValue(key, float128());
+	}
+
+	/// <summary>
+	/// Gets a short string; the default value, if the key is no pyeStringUTF8S.
+	/// </summary>
+	std::string getStringS(const std::string& key, const std::string& defaultValue = std::string()) const {
+		unsigned __int64 offset;
+		unsigned __int8 stringSize;
+		if (!findData(key, pyeValueType::pyeStringUTF8S, offset, stringSize)) {
+			return defaultValue;
+		}
+
+		return std::string(_data.begin() + offset, _data.begin() + offset + stringSize);
+	}
+
+	/// <summary>
+	/// Gets a long string; the default value, if the key is no pyeStringUTF8L.
+	/// </summary>
+	std::string getStringL(const std::string& key, const std::string& defaultValue = std::string()) const {
+		unsigned __int64 offset;
+		unsigned __int32 stringSize;
+		if (!findData(key, pyeValueType::pyeStringUTF8L, offset, stringSize)) {
+			return defaultValue;
+		}
+
+		return std::string(_data.begin() + offset, _data.begin() + offset + stringSize);
+	}
+
+	/// <summary>
+	/// Gets the pointer to the data of a byte stream without a copy.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <param name="data">pointer to the data in the byte stream of the document</param>
+	/// <param name="size">size of the data</param>
+	/// <returns>false, if the key does not exist or is no pyeMemory or the size exceeds the byte stream</returns>
+	bool getMemoryData(const std::string& key, const unsigned char*& data, unsigned __int32& size) const {
+		unsigned __int64 offset;
+		if (!findData(key, pyeValueType::pyeMemory, offset, size)) {
+			return false;
+		}
+
+		data = _data.data() + offset;
+		return true;
+	}
+
+	/// <summary>
+	/// Gets a byte stream; empty, if the key is no pyeMemory.
+	/// </summary>
+	std::vector<unsigned char> getMemory(const std::string& key) const {
+		unsigned __int64 offset;
+		unsigned __int32 memSize;
+		if (!findData(key, pyeValueType::pyeMemory, offset, memSize)) {
+			return std::vector<unsigned char>();
+		}
+
+		return std::vector<unsigned char>(_data.begin() + offset, _data.begin() + offset + memSize);
+	}
+
+	/// <summary>
+	/// Gets a read-only view of a sub-list. The view of the sub-list builds its own index.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <returns>view of the sub-list; empty view if the key does not exist</returns>
+	PyeListView getList(const std::string& key) const {
+		unsigned __int64 offsetObject;
+		if (!findItem(key, offsetObject)) {
+			return PyeListView();
+		}
+		return PyeListView(_data, _buffer, offsetObject, _documentIndex, _cache);
+	}
+
+	/// <summary>
+	/// Gets the items of a pyeArray without a copy.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <param name="data">gets the pointer to the first item</param>
+	/// <param name="count">gets the count of items</param>
+	/// <param name="arrayType">gets the pye value type of the items</param>
+	/// <returns>false, if the key does not exist or is no pyeArray</returns>
+	bool getArrayData(const std::string& key, const unsigned char*& data, unsigned __int32& count, pyeValueType& arrayType) const {
+		unsigned __int64 offset;
+		if (!findValue(key, offset) || _data[offset - 1 /*pye value type*/] != pyeValueType::pyeArray) {
+			return false;
+		}
+
+		arrayType = (pyeValueType)_data[offset];
+		ReadFromVector(count, _data, offset + 1 /*array type*/ + 4 /*size*/);
+		data = _data.data() + offset + 1 /*array type*/ + 4 /*size*/ + 4 /*count*/;
+		return true;
+	}
+
+	/// <summary>
+	/// Gets a pyeArray of a key. The pyeArray is a new object of the caller,
+	/// the getters of the pyeArray only read the byte stream.
+	/// Needs a view of a std::vector, a view of a byte span returns false.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <param name="pyeArray">gets the pyeArray</param>
+	/// <returns>false, if the key does not exist, is no pyeArray or the view reads a byte span; pyeArray is not changed</returns>
+	bool getArray(const std::string& key, PyeArray& pyeArray) const {
+		unsigned __int64 offsetObject;
+		if (_buffer == nullptr || !findContainer(key, pyeValueType::pyeArray, offsetObject)) {
+			return false;
+		}
+
+		pyeArray = PyeArray(const_cast<std::vector<unsigned char>*>(_buffer), offsetObject);
+		return true;
+	}
+
+	/// <summary>
+	/// Gets a pyeArrayMap of a key. The pyeArrayMap is a new object of the caller,
+	/// the getters of the pyeArrayMap only read the byte stream.
+	/// Needs a view of a std::vector, a view of a byte span returns false.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <param name="arrayMap">gets the pyeArrayMap</param>
+	/// <returns>false, if the key does not exist, is no pyeArrayMap or the view reads a byte span; arrayMap is not changed</returns>
+	bool getArrayMap(const std::string& key, PyeArrayMap& arrayMap) const {
+		unsigned __int64 offsetObject;
+		if (_buffer == nullptr || !findContainer(key, pyeValueType::pyeArrayMap, offsetObject)) {
+			return false;
+		}
+
+		arrayMap = PyeArrayMap(const_cast<std::vector<unsigned char>*>(_buffer), offsetObject);
+		if (_cache) {
+			arrayMap.setRowOffsets(_cache->getRowOffsets(_data, offsetObject));
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Gets a pyeColumnMap of a key. The pyeColumnMap is a new object of the caller,
+	/// the getters of the pyeColumnMap only read the byte stream.
+	/// Needs a view of a std::vector, a view of a byte span returns false.
+	/// </summary>
+	/// <param name="key">key name</param>
+	/// <param name="columnMap">gets the pyeColumnMap</param>
+	/// <returns>false, if the key does not exist, is no pyeColumnMap or the view reads a byte span; columnMap is not changed</returns>
+	bool getColumnMap(const std::string& key, PyeColumnMap& columnMap) const {
+		unsigned __int64 offsetObject;
+		if (_buffer == nullptr || !findContainer(key, pyeValueType::pyeColumnMap, offsetObject)) {
+			return false;
+		}
+
+		columnMap = PyeColumnMap(const_cast<std::vector<unsigned char>*>(_buffer), offsetObject);
+		return true;
+	}
+
+private:
+	PyeListView(const PyeByteSpan& data, const std::vector<unsigned char>* buffer, unsigned __int64 offsetObject,
+		std::shared_ptr<const PyeDocumentIndex> documentIndex, std::shared_ptr<PyeContainerCache> cache) {
+		_data = data;
+		_buffer = buffer;
+		_offsetObject = offsetObject;
+		_documentIndex = documentIndex;
+		_cache = cache;
+		decode();
+	}
+
+	void decode() {
+		if (_documentIndex) {
+			std::shared_ptr<const PyeDocumentIndex::ItemIdx> itemIdx = _documentIndex->getItemIdx(_offsetObject);
+			if (itemIdx) {
+				_mapItemIdx = itemIdx;
+				return;
+			}
+		}
+
+		if (PyePerfectHash::hasPerfectHash(_data.data(), _data.size(), _offsetObject)) {
+			_perfectHash = true;
+			_itemIdxOnce = std::make_shared<ItemIdxOnce>();
+			return;
+		}
+
+		if (PyeKeyDirectory::hasDirectory(_data.data(), _data.size(), _offsetObject)) {
+			_keyDirectory = true;
+			_itemIdxOnce = std::make_shared<ItemIdxOnce>();
+			return;
+		}
+
+		if (_cache) {
+			_mapItemIdx = _cache->getItemIdx(_data, _offsetObject);
+			return;
+		}
+
+		std::shared_ptr<PyeDocumentIndex::ItemIdx> itemIdx = std::make_shared<PyeDocumentIndex::ItemIdx>();
+		PyeDocumentIndex::decodeList(_data, _offsetObject, *itemIdx);
+		_mapItemIdx = itemIdx;
+	}
+
+	/// <summary>
+	/// Finds the offset of the pyeKVS object of a key in the index, the key directory or the minimal perfect hash.
+	/// </summary>
+	/// <returns>true, if the key exists</returns>
+	bool findItem(const std::string& key, unsigned __int64& offsetObject) const {
+		if (_perfectHash) {
+			return PyePerfectHash::find(_data.data(), _data.size(), _offsetObject, key, offsetObject);
+		}
+
+		if (_keyDirectory) {
+			return PyeKeyDirectory::find(_data.data(), _data.size(), _offsetObject, key, offsetObject);
+		}
+
+		auto item = _mapItemIdx->find(key);
+		if (item == _mapItemIdx->end()) {
+			return false;
+		}
+		offsetObject = item->second;
+		return true;
+	}
+
+	/// <summary>
+	/// Finds the offset of the pyeKVS object of a key with a container value of the given pye value type.
+	/// </summary>
+	/// <returns>true, if the key exists and has the value type</returns>
+	bool findContainer(const std::string& key, pyeValueType valueType, unsigned __int64& offsetObject) const {
+		if (!findItem(key, offsetObject)) {
+			return false;
+		}
+
+		return _data[offsetObject + 1 + _data[offsetObject] /*key length (uint8) + key chars*/] == valueType;
+	}
+
+	/// <summary>
+	/// Finds the offset of the value data of a key (behind the pye value type).
+	/// </summary>
+	/// <returns>true, if the key exists</returns>
+	bool findValue(const std::string& key, unsigned __int64& offsetValue) const {
+		unsigned __int64 offsetObject;
+		if (!findItem(key, offsetObject)) {
+			return false;
+		}
+
+		offsetValue = offsetObject;
+		offsetValue += 1 + _data[offsetObject];	// information about key length (uint8) + key chars
+		offsetValue += 1;								// information pye value type (uint8)
+		return true;
+	}
+
+	/// <summary>
+	/// Finds the data of a string or memory value of a key with the given pye value type.
+	/// The length information is checked against the end of the byte stream.
+	/// </summary>
+	/// <typeparam name="L">type of the length information</typeparam>
+	/// <returns>true, if the key exists, has the value type and the data fits into the byte stream</returns>
+	template<class L>
+	bool findData(const std::string& key, pyeValueType valueType, unsigned __int64& offsetData, L& size) const {
+		unsigned __int64 offset;
+		if (!findValue(key, offset) || _data[offset - 1 /*pye value type*/] != valueType || offset + sizeof(L) > _data.size()) {
+			return false;
+		}
+
+		ReadFromVector(size, _data, offset);
+		offsetData = offset + sizeof(L);
+		return size <= _data.size() - offsetData;
+	}
+
+	/// <summary>
+	/// Reads a fundamental value; the default value, if the stored pye value type is not readable as T.
+	/// </summary>
+	template<class T>
+	T readValue(const std::string& key, T defaultValue) const {
+		unsigned __int64 offset;
+		if (!findValue(key, offset) || !pyeIsReadableAs<T>((pyeValueType)_data[offset - 1 /*pye value type*/])
+			|| offset + sizeof(T) > _data.size()) {
+			return defaultValue;
+		}
+
+		T result;
+		ReadFromVector(result, _data, offset);
+		return result;
+	}
+};
+
+/// <summary>
+/// Read-only view of a pyeKVS document.
+/// The view holds no own buffer, the byte stream must not be changed while views are in use.
+/// </summary>
+class PyeDocumentView {
+	/// <summary> Length of the header information </summary>
+	static const unsigned __int64 _offsetHeader = 16;
+
+	/// <summary> PyeKVS starts with a pyeList. </summary>
+	PyeListView _rootList;
+
+public:
+	/// <summary> Constructor of a read-only pyeDocument with a pyeKVS buffer.
+	/// </summary>
+	/// <param name="pbuffer">pyeKVS buffer</param>
+	PyeDocumentView(const std::vector<unsigned char>* pbuffer) : _rootList(pbuffer, _offsetHeader) {}
+
+	/// <summary> Constructor of a read-only pyeDocument of the buffer of a pyeDocument.
+	/// </summary>
+	/// <param name="document">pyeDocument</param>
+	PyeDocumentView(PyeDocument& document) : _rootList(document.getBuffer(), _offsetHeader) {}
+
+	/// <summary> Constructor of a read-only pyeDocument with a pyeKVS buffer, the prebuilt index of its lists
+	/// and a cache of the decoded containers. The views of the sub-lists use the same index and cache.
+	/// </summary>
+	/// <param name="pbuffer">pyeKVS buffer</param>
+	/// <param name="documentIndex">index of the lists, see PyeDocumentIndex::build; nullptr: the lists are decoded</param>
+	/// <param name="cache">optional cache of the decoded containers of the buffer</param>
+	PyeDocumentView(const std::vector<unsigned char>* pbuffer, std::shared_ptr<const PyeDocumentIndex> documentIndex,
+		std::shared_ptr<PyeContainerCache> cache = nullptr) : _rootList(pbuffer, _offsetHeader, documentIndex, cache) {}
+
+	/// <summary> Constructor of a read-only pyeDocument of bytes in any memory, e.g. a network buffer, shared memory or a mapped file.
+	/// The bytes are read in place and must outlive the view.
+	/// </summary>
+	/// <param name="data">pointer to the pyeKVS byte stream</param>
+	/// <param name="size">size of the byte stream</param>
+	/// <param name="documentIndex">optional index of the lists, see PyeDocumentIndex::build</param>
+	/// <param name="cache">optional cache of the decoded containers of the byte stream</param>
+	PyeDocumentView(const unsigned char* data, size_t size, std::shared_ptr<const PyeDocumentIndex> documentIndex = nullptr,
+		std::shared_ptr<PyeContainerCache> cache = nullptr) : _rootList(PyeByteSpan(data, size), _offsetHeader, documentIndex, cache) {}
+
+	const std::vector<unsigned char>* getBuffer() const {
+		return _rootList.getBuffer();
+	}
+
+	const PyeByteSpan& getData() const {
+		return _rootList.getData();
+	}
+
+	/// <summary> Gets the prefix of the header of the pyeDoc.
+	/// </summary>
+	unsigned __int32 getHeaderPrefix() const {
+		unsigned __int32 result;
+		ReadFromVector(result, getData(), 0);
+		return result;
+	}
+
+	/// <summary> Gets the high version number of the pyeKVS definition.
+	/// </summary>
+	unsigned __int16 getHeaderVersionH() const {
+		unsigned __int16 result;
+		ReadFromVector(result, getData(), 4);
+		return result;
+	}
+
+	/// <summary> Gets the low version number of the pyeKVS definition.
+	/// </summary>
+	unsigned __int16 getHeaderVersionL() const {
+		unsigned __int16 result;
+		ReadFromVector(result, getData(), 6);
+		return result;
+	}
+
+	/// <summary> Gets the size of the data behind the header of the pyeDoc.
+	/// </summary>
+	unsigned __int64 getHeaderSize() const {
+		unsigned __int64 result;
+		ReadFromVector(result, getData(), 8);
+		return result;
+	}
+
+	/// <summary> Returns the read-only root list of this pyeDoc.
+	/// </summary>
+	/// <returns>PyeListView</returns>
+	const PyeListView& getRoot() const {
+		return _rootList;
+	}
+};
@@ -13,8 +13,29 @@
 #include <map>
 #include <iostream>     // std::cout
 #include <fstream>      // std::ifstream
+#include <thread>
+#include <chrono>
+#include <algorithm>
 
 #include "pyeKVS.h"
+#include "pyeKVSDiff.h"
+#include "pyeKVSMerge.h"
+#include "pyeKVSView.h"
+#include "pyeKVSIndex.h"
+#include "pyeKVSBuild.h"
+#include "pyeKVSSchema.h"
+#include "pyeKVSScan.h"
+#include "pyeKVSColumnIndex.h"
+#include "pyeKVSDirectory.h"
+#include "pyeKVSPerfectHash.h"
+#include "pyeKVSCompress.h"
+#include "pyeKVSNumeric.h"
+#include "pyeKVSKeys.h"
+#include "pyeKVSShared.h"
+#include "pyeKVSRing.h"
+#include "pyeKVSStore.h"
+#include "pyeKVSLog.h"
+#include "pyeKVSVersion.h"
 
 #ifdef _DEBUG
 #define new DEBUG_NEW
@@ -50,6 +71,1290 @@ void writeBufferToFile(const char* filename, std::vector<unsigned char>& fileByt
 	std::copy(fileBytes.cbegin(), fileBytes.cend(), std::ostream_iterator<unsigned char>(file));
 }
 
+/*
+* Testbench of the pyeKVS extensions
+* Every test writes data, reads it back and checks the result with VERIFY.
+*/
+
+/*
+* Test 4: diff of two documents and patch of the old document to the new document
+*/
+void testDiffPatch() {
+	PyeDocument docOld;
+	docOld.getRoot().putInt32(1, "keep");
+	docOld.getRoot().putInt32(2, "change");
+	docOld.getRoot().putStringS("removed", "remove");
+	PyeList listOld = docOld.getRoot().putList("list");
+	listOld.putDouble(1.5, "value");
+
+	PyeDocument docNew;
+	docNew.getRoot().putInt32(1, "keep");
+	docNew.getRoot().putInt32(3, "change");
+	docNew.getRoot().putStringS("added", "add");
+	PyeList listNew = docNew.getRoot().putList("list");
+	listNew.putDouble(2.5, "value");
+
+	PyeDocument docPatch = PyeDiff::diff(docOld, docNew);
+	PyeDocument docPatched = PyeDiff::patch(docOld, docPatch);
+
+	VERIFY(docPatched.getRoot().getInt32("keep") == 1);
+	VERIFY(docPatched.getRoot().getInt32("change") == 3);
+	VERIFY(docPatched.getRoot().getStringS("add") == "added");
+	VERIFY(docPatched.getRoot().getItemIdx().count("remove") == 0);
+	VERIFY(docPatched.getRoot().getList("list").getDouble("value") == 2.5);
+
+	// an equal document gives an empty patch
+	PyeDocument docEqual = PyeDiff::diff(docNew, docNew);
+	VERIFY(docEqual.getRoot().getCount() == 0);
+}
+
+/*
+* Test 5: merge of two documents with both policies and with merged sub-lists
+*/
+void testMerge() {
+	PyeDocument docTarget;
+	docTarget.getRoot().putInt32(1, "both");
+	docTarget.getRoot().putInt32(2, "target");
+	PyeList listTarget = docTarget.getRoot().putList("list");
+	listTarget.putStringS("target", "a");
+
+	PyeDocument docSource;
+	docSource.getRoot().putInt32(10, "both");
+	docSource.getRoot().putInt32(20, "source");
+	PyeList listSource = docSource.getRoot().putList("list");
+	listSource.putStringS("source", "b");
+
+	PyeDocument docMerged = PyeMerge::merge(docTarget, docSource, pyeMergeTakeSource);
+	VERIFY(docMerged.getRoot().getInt32("both") == 10);
+	VERIFY(docMerged.getRoot().getInt32("target") == 2);
+	VERIFY(docMerged.getRoot().getInt32("source") == 20);
+	VERIFY(docMerged.getRoot().getList("list").getStringS("a") == "target");
+	VERIFY(docMerged.getRoot().getList("list").getStringS("b") == "source");
+
+	PyeDocument docKept = PyeMerge::merge(docTarget, docSource, pyeMergeKeepTarget, false);
+	VERIFY(docKept.getRoot().getInt32("both") == 1);
+	VERIFY(docKept.getRoot().getList("list").getItemIdx().count("b") == 0);
+}
+
+/*
+* Test 6: read-only view of a document shared by several reader threads, missing keys and containers
+*/
+void testViewReaders() {
+	PyeDocument doc;
+	for (int idx = 0; idx < 100; idx++) {
+		doc.getRoot().putInt32(idx, "key" + std::to_string(idx));
+	}
+	PyeArray pyeArray = doc.getRoot().putArray("array", pyeValueType::pyeInt16);
+	pyeArray.putInt16(7);
+
+	PyeDocumentView view(doc);
+	std::vector<int> errors(4, 0);
+	std::vector<std::thread> readers;
+	for (int thread = 0; thread < 4; thread++) {
+		readers.push_back(std::thread([&view, &errors, thread]() {
+			for (int idx = 0; idx < 100; idx++) {
+				if (view.getRoot().getInt32("key" + std::to_string(idx), -1) != idx) {
+					errors[thread]++;
+				}
+			}
+		}));
+	}
+	for (std::thread& reader : readers) {
+		reader.join();
+	}
+	for (int error : errors) {
+		VERIFY(error == 0);
+	}
+
+	VERIFY(view.getRoot().getInt32("missing", -1) == -1);
+
+	PyeArray arrayBack(nullptr, 0);
+	VERIFY(view.getRoot().getArray("array", arrayBack));
+	VERIFY(arrayBack.getCount() == 1 && arrayBack.getInt16(0) == 7);
+	VERIFY(!view.getRoot().getArray("missing", arrayBack));
+	VERIFY(!view.getRoot().getArray("key1", arrayBack));
+
+	PyeArrayMap arrayMapBack(nullptr, 0);
+	VERIFY(!view.getRoot().getArrayMap("missing", arrayMapBack));
+	PyeColumnMap columnMapBack(nullptr, 0);
+	VERIFY(!view.getRoot().getColumnMap("array", columnMapBack));
+}
+
+/*
+* Test 7: parallel index of all lists of a document, views of the lists with the prebuilt index
+*/
+void testParallelIndex() {
+	PyeDocument doc;
+	for (int idxList = 0; idxList < 16; idxList++) {
+		PyeList list = doc.getRoot().putList("list" + std::to_string(idxList));
+		for (int idx = 0; idx < 50; idx++) {
+			list.putInt32(idxList * 100 + idx, "key" + std::to_string(idx));
+		}
+		PyeList subList = list.putList("sub");
+		subList.putInt32(idxList, "value");
+	}
+
+	std::shared_ptr<PyeDocumentIndex> documentIndex = std::make_shared<PyeDocumentIndex>();
+	documentIndex->build(doc.getBuffer(), 16, 4);
+	VERIFY(documentIndex->getCountLists() == 1 + 16 + 16);
+
+	PyeDocumentView view(doc.getBuffer(), documentIndex);
+	VERIFY(view.getRoot().getList("list7").getInt32("key42") == 742);
+	VERIFY(view.getRoot().getList("list15").getList("sub").getInt32("value") == 15);
+	VERIFY(view.getRoot().getList("list3").getItemIdx().size() == 51);
+}
+
+/*
+* Test 8: parallel build of sub-lists and splice into the parent list, copy of a value within the same buffer
+*/
+void testParallelBuild() {
+	PyeDocument doc;
+	doc.getRoot().putInt32(1, "first");
+
+	PyeParallelBuilder builder;
+	for (int idxList = 0; idxList < 8; idxList++) {
+		builder.add("list" + std::to_string(idxList), [idxList](PyeList& list) {
+			for (int idx = 0; idx < 100; idx++) {
+				list.putInt32(idxList * 1000 + idx, "key" + std::to_string(idx));
+			}
+		});
+	}
+	builder.build(doc.getRoot(), 4);
+
+	VERIFY(doc.getRoot().getCount() == 9);
+	VERIFY(doc.getRoot().getList("list5").getInt32("key77") == 5077);
+
+	PyeDocument docBack(doc.getBuffer());
+	VERIFY(docBack.getRoot().getList("list7").getInt32("key99") == 7099);
+
+	// the source of the value is the buffer of the list itself
+	doc.getRoot().putRawValue("copy", *doc.getBuffer(), doc.getRoot().getItemIdx().at("list2"));
+	VERIFY(doc.getRoot().getList("copy").getInt32("key10") == 2010);
+	VERIFY(doc.getRoot().getList("list2").getInt32("key10") == 2010);
+}
+
+/*
+* Test 9: encode and decode of a struct with a compile-time schema
+*/
+struct PyeTestMessage {
+	__int32 id;
+	double value;
+	std::string unit;
+	bool valid;
+};
+
+PYE_SCHEMA(PyeTestMessage,
+	PYE_FIELD(PyeTestMessage, id),
+	PYE_FIELD(PyeTestMessage, value),
+	PYE_FIELD(PyeTestMessage, unit),
+	PYE_FIELD(PyeTestMessage, valid));
+
+void testSchema() {
+	PyeTestMessage message = { 42, 3.25, "mm", false };
+
+	PyeDocument doc;
+	PyeList list = doc.getRoot().putList("message");
+	PyeSchemaCodec<PyeTestMessage>::put(list, message);
+	VERIFY(list.getCount() == 4);
+
+	PyeTestMessage messageBack = { 0, 0.0, "", true };
+	PyeSchemaReader<PyeTestMessage> reader;
+	VERIFY(reader.bind(list));
+	reader.read(messageBack);
+	VERIFY(messageBack.id == 42 && messageBack.value == 3.25 && messageBack.unit == "mm" && !messageBack.valid);
+
+	// a list with a missing key binds the other fields
+	PyeList listPart = doc.getRoot().putList("part");
+	listPart.putInt32(7, "id");
+	VERIFY(!reader.bind(listPart));
+	VERIFY(reader.isBound(0) && !reader.isBound(1));
+	reader.read(messageBack);
+	VERIFY(messageBack.id == 7 && messageBack.unit == "mm");
+}
+
+/*
+* Test 10: typed put<V> and get<V> with the stored pye value type
+*/
+void testTypedPutGet() {
+	PyeDocument doc;
+	PyeList list = doc.getRoot().putList("typed");
+	list.put<__int32>(-32, "int32");
+	list.put<double>(6.4, "double");
+	list.put<bool>(true, "true");
+	list.put<bool>(false, "false");
+	list.put<std::string>("long", "stringL");
+	list.putStringS("short", "stringS");
+	list.put<uInt128>(uInt128(1, 2), "uint128");
+
+	VERIFY(list.get<__int32>("int32") == -32);
+	VERIFY(list.get<double>("double") == 6.4);
+	VERIFY(list.get<bool>("true"));
+	VERIFY(!list.get<bool>("false"));
+	VERIFY(list.get<std::string>("stringL") == "long");
+	VERIFY(list.get<std::string>("stringS") == "short");
+	VERIFY(list.get<uInt128>("uint128") == uInt128(1, 2));
+
+	// a stored pye value type which is not readable as the C++ type gives the default value
+	VERIFY(list.get<double>("int32") == 0.0);
+	VERIFY(list.get<std::string>("int32").empty());
+
+	PyeArray pyeArray = list.putArray("array", pyeValueType::pyeUInt16);
+	pyeArray.putUInt16(16);
+	VERIFY(pyeArray.get<unsigned __int16>(0) == 16);
+	VERIFY(pyeArray.get<__int16>(0) == 0);
+}
+
+/*
+* Test 11: vector of structs as rows of a pyeArrayMap, fixed-size and variable-size rows
+*/
+struct PyeTestPoint {
+	__int32 id;
+	double x;
+	float y;
+};
+
+PYE_SCHEMA(PyeTestPoint,
+	PYE_FIELD(PyeTestPoint, id),
+	PYE_FIELD(PyeTestPoint, x),
+	PYE_FIELD(PyeTestPoint, y));
+
+struct PyeTestLabel {
+	unsigned __int16 id;
+	std::string text;
+};
+
+PYE_SCHEMA(PyeTestLabel,
+	PYE_FIELD(PyeTestLabel, id),
+	PYE_FIELD(PyeTestLabel, text));
+
+void testSchemaRows() {
+	std::vector<PyeTestPoint> points;
+	for (int idx = 0; idx < 1000; idx++) {
+		points.push_back({ idx, idx * 0.5, idx * 0.25f });
+	}
+	std::vector<PyeTestLabel> labels = { { 1, "one" }, { 2, "" }, { 3, "three" } };
+
+	PyeDocument doc;
+	PyeSchemaRows<PyeTestPoint>::put(doc.getRoot(), "points", points);
+	PyeSchemaRows<PyeTestLabel>::put(doc.getRoot(), "labels", labels);
+
+	PyeArrayMap arrayPoints = doc.getRoot().getArrayMap("points");
+	VERIFY(arrayPoints.getCount() == 1000);
+	VERIFY(arrayPoints.getDouble(999, 1) == 499.5);
+
+	std::vector<PyeTestPoint> pointsBack;
+	VERIFY(PyeSchemaRows<PyeTestPoint>::get(arrayPoints, pointsBack));
+	VERIFY(pointsBack.size() == 1000);
+	VERIFY(pointsBack[500].id == 500 && pointsBack[500].x == 250.0 && pointsBack[500].y == 125.0f);
+
+	PyeArrayMap arrayLabels = doc.getRoot().getArrayMap("labels");
+	std::vector<PyeTestLabel> labelsBack;
+	VERIFY(PyeSchemaRows<PyeTestLabel>::get(arrayLabels, labelsBack));
+	VERIFY(labelsBack.size() == 3 && labelsBack[1].text.empty() && labelsBack[2].text == "three");
+
+	// the mapStruct of another schema does not match
+	VERIFY(!PyeSchemaRows<PyeTestLabel>::get(arrayPoints, labelsBack));
+}
+
+/*
+* Test 12: pyeColumnMap, put by rows and read by items and columns
+*/
+void testColumnMap() {
+	std::vector<pyeValueType> mapStruct{ pyeValueType::pyeInt32, pyeValueType::pyeStringUTF8S, pyeValueType::pyeFloat64 };
+
+	PyeDocument doc;
+	PyeColumnMap columnMap = doc.getRoot().putColumnMap("columns", mapStruct);
+	for (int row = 0; row < 3; row++) {
+		columnMap.putInt32(row * 10);
+		columnMap.putStringS("row" + std::to_string(row));
+		columnMap.putDouble(row + 0.5);
+	}
+
+	PyeDocument docBack(doc.getBuffer());
+	PyeColumnMap columnMapBack = docBack.getRoot().getColumnMap("columns");
+	VERIFY(columnMapBack.getCount() == 3);
+	VERIFY(columnMapBack.getInt32(2, 0) == 20);
+	VERIFY(columnMapBack.getStringS(1, 1) == "row1");
+	VERIFY(columnMapBack.getDouble(0, 2) == 0.5);
+
+	std::vector<double> column;
+	VERIFY(columnMapBack.getColumn(2, column));
+	VERIFY(column.size() == 3 && column[2] == 2.5);
+	VERIFY(!columnMapBack.getColumn(0, column));
+
+	VERIFY(columnMapBack.toStringJSON() == "[[\"0\",\"row0\",\"0.500000\"],[\"10\",\"row1\",\"1.500000\"],[\"20\",\"row2\",\"2.500000\"]],");
+}
+
+/*
+* Test 13: predicate scan with column projection over a pyeArrayMap
+*/
+void testScan() {
+	std::vector<pyeValueType> mapStruct{ pyeValueType::pyeInt32, pyeValueType::pyeStringUTF8S, pyeValueType::pyeFloat64 };
+
+	PyeDocument doc;
+	PyeArrayMap arrayMap = doc.getRoot().putArrayMap("rows", mapStruct);
+	for (int row = 0; row < 100; row++) {
+		arrayMap.putInt32(row);
+		arrayMap.putStringS(row % 2 ? "odd" : "even");
+		arrayMap.putDouble(row * 1.5);
+	}
+
+	PyeScan scan;
+	scan.where(0, pyeScanGreaterEqual, 90).where(1, pyeScanEqual, "odd");
+
+	std::vector<unsigned __int32> rows;
+	VERIFY(scan.scan(arrayMap, rows));
+	VERIFY(rows.size() == 5 && rows[0] == 91 && rows[4] == 99);
+
+	std::vector<double> values;
+	VERIFY(scan.scan(arrayMap, 2, values));
+	VERIFY(values.size() == 5 && values[0] == 136.5);
+
+	double sum = 0;
+	VERIFY(scan.scanRows(arrayMap, [&](unsigned __int32 row, const PyeScanRow& rowValues) {
+		sum += rowValues.get<double>(2) - row;
+	}));
+	VERIFY(sum == 0.5 * (91 + 93 + 95 + 97 + 99));
+
+	// the projected column is not readable as __int32, a predicate column does not exist
+	std::vector<__int32> valuesInt;
+	VERIFY(!scan.scan(arrayMap, 2, valuesInt));
+	PyeScan scanWrong;
+	scanWrong.where(3, pyeScanEqual, 1);
+	VERIFY(!scanWrong.scan(arrayMap, rows));
+}
+
+/*
+* Test 14: sorted secondary index on a column, point and range lookups, put and load of the index
+*/
+void testColumnIndex() {
+	std::vector<pyeValueType> mapStruct{ pyeValueType::pyeInt64, pyeValueType::pyeStringUTF8S };
+
+	PyeDocument doc;
+	PyeArrayMap arrayMap = doc.getRoot().putArrayMap("rows", mapStruct);
+	for (int row = 0; row < 200; row++) {
+		arrayMap.putInt64((row * 37) % 200);
+		arrayMap.putStringS("row" + std::to_string(row));
+	}
+
+	PyeColumnIndex<__int64> index;
+	VERIFY(index.build(arrayMap, 0));
+
+	unsigned __int32 row;
+	VERIFY(index.find(37, row) && row == 1);
+	VERIFY(!index.find(4711, row));
+
+	std::vector<unsigned __int32> rows;
+	VERIFY(index.findRange(10, 19, rows) == 10);
+
+	index.put(doc.getRoot(), "idxRows");
+	PyeArrayMap arrayMapIdx = doc.getRoot().getArrayMap("idxRows");
+	PyeColumnIndex<__int64> indexBack;
+	VERIFY(indexBack.load(arrayMapIdx));
+	VERIFY(indexBack.find(74, row) && row == 2);
+
+	// a string column can not be indexed as numbers
+	PyeColumnIndex<__int64> indexWrong;
+	VERIFY(!indexWrong.build(arrayMap, 1));
+}
+
+/*
+* Test 15: list with a key directory, lookups and schema bind on a view without decoding the list
+*/
+void testKeyDirectory() {
+	PyeTestMessage message = { 7, 1.5, "kg", true };
+
+	PyeDocument doc;
+	PyeList list = doc.getRoot().putList("message");
+	PyeSchemaCodec<PyeTestMessage>::put(list, message);
+	PyeKeyDirectory::put(list);
+	VERIFY(PyeKeyDirectory::hasDirectory(*doc.getBuffer(), list.getOffsetObject()));
+
+	PyeDocumentView view(doc);
+	PyeListView listView = view.getRoot().getList("message");
+	VERIFY(listView.getInt32("id", -1) == 7);
+	VERIFY(listView.getStringL("unit", "") == "kg");
+	VERIFY(listView.getItemIdx().size() == 4);
+
+	PyeTestMessage messageBack = { 0, 0.0, "", false };
+	PyeSchemaReader<PyeTestMessage> reader;
+	VERIFY(reader.bind(listView));
+	reader.read(messageBack);
+	VERIFY(messageBack.id == 7 && messageBack.value == 1.5 && messageBack.unit == "kg" && messageBack.valid);
+}
+
+/*
+* Test 16: list with a minimal perfect hash, lookups of all keys and of missing keys on a view
+*/
+void testPerfectHash() {
+	PyeDocument doc;
+	PyeList list = doc.getRoot().putList("immutable");
+	for (int idx = 0; idx < 1000; idx++) {
+		list.putInt32(idx, "key" + std::to_string(idx));
+	}
+	VERIFY(PyePerfectHash::put(list));
+	VERIFY(PyePerfectHash::hasPerfectHash(*doc.getBuffer(), list.getOffsetObject()));
+
+	PyeDocumentView view(doc);
+	PyeListView listView = view.getRoot().getList("immutable");
+	int errors = 0;
+	for (int idx = 0; idx < 1000; idx++) {
+		if (listView.getInt32("key" + std::to_string(idx), -1) != idx) {
+			errors++;
+		}
+	}
+	VERIFY(errors == 0);
+	VERIFY(listView.getInt32("key1000", -1) == -1);
+	VERIFY(!listView.hasKey("missing"));
+	VERIFY(listView.getItemIdx().size() == 1000);
+
+	// the decoded document reads the list with the hash as last object
+	PyeDocument docBack(doc.getBuffer());
+	VERIFY(docBack.getRoot().getList("immutable").getInt32("key999") == 999);
+}
+
+/*
+* Test 17: block compression of a document and of a pyeMemory, decode of a byte range and of a damaged stream
+*/
+void testBlockCompression() {
+	PyeDocument doc;
+	for (int idx = 0; idx < 5000; idx++) {
+		doc.getRoot().putInt32(idx % 100, "key" + std::to_string(idx));
+	}
+
+	std::vector<unsigned char> stream;
+	PyeBlockCompression::encode(*doc.getBuffer(), stream, PyeCodecLZ(), 4096);
+	VERIFY(stream.size() < doc.getBuffer()->size());
+
+	unsigned __int64 rawSize;
+	VERIFY(PyeBlockCompression::getRawSize(stream.data(), stream.size(), rawSize) && rawSize == doc.getBuffer()->size());
+
+	std::vector<unsigned char> data;
+	VERIFY(PyeBlockCompression::decode(stream, data));
+	VERIFY(data == *doc.getBuffer());
+
+	// a range over a block border
+	VERIFY(PyeBlockCompression::decodeRange(stream.data(), stream.size(), 4000, 200, data));
+	VERIFY(data.size() == 200 && std::equal(data.begin(), data.end(), doc.getBuffer()->begin() + 4000));
+	VERIFY(!PyeBlockCompression::decodeRange(stream.data(), stream.size(), rawSize - 10, 20, data));
+
+	std::vector<unsigned char> streamDamaged(stream.begin(), stream.begin() + stream.size() / 2);
+	VERIFY(!PyeBlockCompression::decode(streamDamaged, data));
+
+	PyeDocument docMemory;
+	PyeBlockCompression::putMemory(docMemory.getRoot(), "blob", *doc.getBuffer());
+	PyeDocument docBack(docMemory.getBuffer());
+	std::vector<unsigned char> blob = docBack.getRoot().getMemory("blob");
+	VERIFY(PyeBlockCompression::decode(blob, data) && data == *doc.getBuffer());
+}
+
+/*
+* Test 18: numeric codecs, delta bit-packing of integers with all bit widths and xor encoding of doubles
+*/
+void testNumericArray() {
+	// steps of growing size give blocks with all bit widths up to 64
+	std::vector<__int64> values;
+	__int64 value = 0;
+	for (int width = 0; width < 64; width++) {
+		for (int idx = 0; idx < 128; idx++) {
+			__int64 step = width == 0 ? 5 : (__int64)((1ULL << width) - 1) * (idx % 2 == 0 ? -1 : 1);
+			value += step;
+			values.push_back(value);
+		}
+	}
+	values.push_back(INT64_MIN);
+	values.push_back(INT64_MAX);
+
+	std::vector<unsigned char> stream;
+	PyeNumericArray::encode(values.data(), values.size(), stream);
+	std::vector<__int64> valuesBack;
+	VERIFY(PyeNumericArray::decode(stream.data(), stream.size(), valuesBack));
+	VERIFY(valuesBack == values);
+
+	std::vector<__int32> valuesWrong;
+	VERIFY(!PyeNumericArray::decode(stream.data(), stream.size(), valuesWrong));
+
+	std::vector<double> measurements;
+	for (int idx = 0; idx < 1000; idx++) {
+		measurements.push_back(idx % 10 == 0 ? 20.5 : 20.5 + idx * 0.001);
+	}
+	PyeDocument doc;
+	PyeNumericArray::put(doc.getRoot(), "measurements", measurements);
+	PyeDocument docBack(doc.getBuffer());
+	std::vector<double> measurementsBack;
+	VERIFY(PyeNumericArray::get(docBack.getRoot(), "measurements", measurementsBack));
+	VERIFY(measurementsBack == measurements);
+}
+
+/*
+* Test 19: interned keys of a key dictionary, lookups with the handles and escaped key names
+*/
+void testInternedKeys() {
+	PyeKeyDictionary dictionary;
+	PyeKey keyId = dictionary.intern("id");
+	PyeKey keyValue = dictionary.intern("value");
+	VERIFY(keyId.isInterned() && dictionary.intern("id") == keyId);
+
+	PyeDocument doc;
+	for (int idx = 0; idx < 10; idx++) {
+		PyeList sensor = doc.getRoot().putList("sensor" + std::to_string(idx));
+		sensor.putInt32(idx, keyId);
+		sensor.putDouble(idx * 0.5, keyValue);
+	}
+
+	// a key name with the prefix of interned keys is escaped and not read as interned key
+	PyeKey keyEscaped("\x01" "ab");
+	VERIFY(!keyEscaped.isInterned() && !pyeIsInternedKey(keyEscaped));
+	doc.getRoot().putInt32(42, keyEscaped);
+	dictionary.put(doc.getRoot());
+
+	PyeDocument docBack(doc.getBuffer());
+	PyeKeyDictionary dictionaryBack;
+	VERIFY(dictionaryBack.load(docBack.getRoot()));
+	PyeKey keyIdBack;
+	VERIFY(dictionaryBack.find("id", keyIdBack) && keyIdBack == keyId);
+	VERIFY(docBack.getRoot().getList("sensor7").getInt32(keyIdBack) == 7);
+	VERIFY(docBack.getRoot().getInt32(keyEscaped) == 42);
+
+	// interned keys are first in the index, in the order of their ids
+	PyeList sensorBack = docBack.getRoot().getList("sensor3");
+	const PyeItemIdx& itemIdx = sensorBack.getItemIdx();
+	VERIFY(itemIdx.size() == 2 && dictionaryBack.getName(itemIdx.begin()->first) == "id");
+	VERIFY(dictionaryBack.getName(keyEscaped) == "\x01" "ab");
+
+	PyeDocumentView view(doc);
+	VERIFY(view.getRoot().getList("sensor9").getDouble(keyValue, 0.0) == 4.5);
+}
+
+/*
+* Test 20: 128-bit values, round trip and order of int128, uInt128 and float128
+*/
+void testValue128() {
+	int128 minusOne(~0ULL, ~0ULL);
+	int128 one(1, 0);
+	VERIFY(minusOne < one && !(one < minusOne));
+
+	uInt128 big(0, 1);
+	uInt128 small(~0ULL, 0);
+	VERIFY(small < big);
+
+	// float128 with sign bit 127: -2.0, -1.0, -0.0, +0.0, 1.0, 2.0
+	float128 minusTwo(0, 0xC000000000000000ULL);
+	float128 minusOneFloat(0, 0xBFFF000000000000ULL);
+	float128 minusZero(0, 0x8000000000000000ULL);
+	float128 zero(0, 0);
+	float128 oneFloat(0, 0x3FFF000000000000ULL);
+	float128 two(0, 0x4000000000000000ULL);
+	std::vector<float128> values{ two, minusZero, oneFloat, minusTwo, zero, minusOneFloat };
+	std::sort(values.begin(), values.end());
+	VERIFY(values == std::vector<float128>({ minusTwo, minusOneFloat, minusZero, zero, oneFloat, two }));
+
+	PyeDocument doc;
+	doc.getRoot().putInt128(minusOne, "int128");
+	doc.getRoot().putFloat128(minusTwo, "float128");
+	PyeDocument docBack(doc.getBuffer());
+	VERIFY(docBack.getRoot().getInt128("int128") == minusOne);
+	VERIFY(docBack.getRoot().getFloat128("float128") == minusTwo);
+}
+
+/*
+* Test 21: buffer pool, documents reuse the released buffers and keep their capacity
+*/
+void testBufferPool() {
+	PyeBufferPool pool(1024, 4);
+	std::vector<unsigned char>* bufferFirst = nullptr;
+	for (int message = 0; message < 10; message++) {
+		PyeDocument doc(pool);
+		for (int idx = 0; idx < 200; idx++) {
+			doc.getRoot().putInt32(idx, "key" + std::to_string(idx));
+		}
+		if (message == 0) {
+			bufferFirst = doc.getBuffer();
+		}
+		VERIFY(doc.getBuffer() == bufferFirst);
+
+		PyeDocument docBack(doc.getBuffer());
+		VERIFY(docBack.getRoot().getInt32("key199") == 199);
+	}
+	VERIFY(pool.getCountFree() == 1);
+
+	// the buffer returns to the pool with the last copy of the document
+	{
+		PyeDocument doc(pool);
+		PyeDocument docCopy = doc;
+		VERIFY(pool.getCountFree() == 0);
+		doc.reset();
+	}
+	VERIFY(pool.getCountFree() == 1);
+
+	pool.clear();
+	VERIFY(pool.getCountFree() == 0);
+}
+
+/*
+* Test 22: view of a byte span in caller memory, values and arrays without a copy, containers and schema need a std::vector
+*/
+void testSpanView() {
+	PyeDocument doc;
+	doc.getRoot().putInt32(7, "id");
+	doc.getRoot().putStringS("mm", "unit");
+	PyeArray pyeArray = doc.getRoot().putArray("array", pyeValueType::pyeInt16);
+	pyeArray.putInt16(3);
+	pyeArray.putInt16(4);
+	PyeList message = doc.getRoot().putList("message");
+	PyeTestMessage messageIn = { 1, 2.5, "kg", true };
+	PyeSchemaCodec<PyeTestMessage>::put(message, messageIn);
+
+	// a copy in memory of the caller, e.g. a mapped file
+	std::vector<unsigned char> memory(*doc.getBuffer());
+	PyeDocumentView view(memory.data(), memory.size());
+	VERIFY(view.getRoot().getInt32("id", -1) == 7);
+	VERIFY(view.getRoot().getStringS("unit") == "mm");
+
+	const unsigned char* data;
+	unsigned __int32 count;
+	pyeValueType arrayType;
+	VERIFY(view.getRoot().getArrayData("array", data, count, arrayType));
+	VERIFY(count == 2 && arrayType == pyeValueType::pyeInt16 && data[2] == 4);
+
+	PyeArray arrayBack(nullptr, 0);
+	VERIFY(!view.getRoot().getArray("array", arrayBack));
+
+	PyeSchemaReader<PyeTestMessage> reader;
+	PyeListView messageView = view.getRoot().getList("message");
+	VERIFY(messageView.getDouble("value") == 2.5);
+	VERIFY(!reader.bind(messageView) && !reader.isBound(0));
+
+	PyeDocumentView viewVector(&memory);
+	VERIFY(viewVector.getRoot().getArray("array", arrayBack) && arrayBack.getInt16(1) == 4);
+	PyeListView messageVector = viewVector.getRoot().getList("message");
+	VERIFY(reader.bind(messageVector));
+}
+
+/*
+* Test 23: shared memory exchange, publish of a document, read without a copy, reuse of the slot invalidates old snapshots
+*/
+void testSharedMemory() {
+	PyeSharedDocumentWriter writer;
+	VERIFY(writer.create("/pyeKVS.testbench", 4096));
+
+	PyeSharedDocumentReader reader;
+	PyeSharedSnapshot snapshot;
+	VERIFY(reader.attach("/pyeKVS.testbench"));
+	VERIFY(reader.getGeneration() == 0 && !reader.read(snapshot));
+
+	PyeDocument doc;
+	doc.getRoot().putInt32(1, "count");
+	doc.getRoot().putStringS("first", "name");
+	VERIFY(writer.publish(doc) && writer.getGeneration() == 1);
+
+	VERIFY(reader.read(snapshot) && snapshot.generation == 1);
+	VERIFY(snapshot.getView().getRoot().getInt32("count", -1) == 1);
+	VERIFY(snapshot.getView().getRoot().getStringS("name") == "first");
+	VERIFY(reader.isValid(snapshot) && !reader.hasNewer(snapshot));
+
+	// the next document goes to the other slot, the snapshot stays valid
+	PyeDocument doc2;
+	doc2.getRoot().putInt32(2, "count");
+	VERIFY(writer.publish(doc2));
+	VERIFY(reader.hasNewer(snapshot) && reader.isValid(snapshot));
+	VERIFY(snapshot.getView().getRoot().getInt32("count", -1) == 1);
+
+	// the third document reuses the slot of the snapshot
+	PyeDocument doc3;
+	doc3.getRoot().putInt32(3, "count");
+	VERIFY(writer.publish(doc3));
+	VERIFY(!reader.isValid(snapshot));
+	VERIFY(reader.read(snapshot) && snapshot.generation == 3);
+	VERIFY(snapshot.getView().getRoot().getInt32("count", -1) == 3);
+
+	std::vector<unsigned char> tooLarge(8192, 0);
+	VERIFY(!writer.publish(PyeByteSpan(tooLarge)));
+
+	reader.detach();
+	writer.close();
+	VERIFY(!reader.attach("/pyeKVS.testbench"));
+}
+
+/*
+* Test 24: ring buffer, one producer thread hands documents to two consumers, wrap around the end of the ring
+*/
+void testRingBuffer() {
+	PyeRingBuffer ring(256, 2);
+	VERIFY(ring.getCapacity() == 256 && ring.getCountConsumers() == 2);
+
+	std::vector<unsigned char> tooLarge(512, 0);
+	VERIFY(!ring.publish(PyeByteSpan(tooLarge)));
+
+	const __int32 countDocuments = 1000;
+	std::thread producer([&ring, countDocuments]() {
+		for (__int32 i = 0; i < countDocuments; i++) {
+			PyeDocument doc;
+			doc.getRoot().putInt32(i, "index");
+			doc.getRoot().putStringS(std::string(i % 40, 'x'), "text");
+			VERIFY(ring.publish(doc));
+		}
+		ring.close();
+	});
+
+	__int32 countRead[2] = { 0, 0 };
+	std::thread consumers[2];
+	for (unsigned int consumer = 0; consumer < 2; consumer++) {
+		consumers[consumer] = std::thread([&ring, &countRead, consumer]() {
+			PyeByteSpan data;
+			while (!ring.isFinished(consumer)) {
+				if (!ring.read(consumer, data)) {
+					std::this_thread::yield();
+					continue;
+				}
+				PyeDocumentView view(data.data(), data.size());
+				__int32 index = view.getRoot().getInt32("index", -1);
+				VERIFY(index == countRead[consumer]);
+				VERIFY(view.getRoot().getStringS("text").size() == (size_t)(index % 40));
+				ring.release(consumer);
+				countRead[consumer]++;
+			}
+		});
+	}
+
+	producer.join();
+	consumers[0].join();
+	consumers[1].join();
+	VERIFY(countRead[0] == countDocuments && countRead[1] == countDocuments);
+
+	// a frame larger than half the ring behind the middle of the ring: the padding is published first
+	PyeRingBuffer ringSmall(64, 1);
+	PyeDocument docSmall;
+	VERIFY(docSmall.getBuffer()->size() <= 32);
+	PyeDocument docLarge;
+	docLarge.getRoot().putInt64(4711, "abcd");
+	VERIFY(docLarge.getBuffer()->size() > 32 && docLarge.getBuffer()->size() <= 64);
+
+	PyeByteSpan data;
+	VERIFY(ringSmall.publish(docSmall) && ringSmall.read(0, data));
+	ringSmall.release(0);
+	VERIFY(ringSmall.tryReserve(docLarge.getBuffer()->size()) == nullptr);
+	VERIFY(!ringSmall.read(0, data));
+	VERIFY(ringSmall.publish(docLarge) && ringSmall.read(0, data));
+	VERIFY(PyeDocumentView(data.data(), data.size()).getRoot().getInt64("abcd", 0) == 4711);
+	ringSmall.release(0);
+
+	// with a consumer thread the producer does not wait forever
+	std::thread consumerSmall([&ringSmall]() {
+		PyeByteSpan dataSmall;
+		while (!ringSmall.isFinished(0)) {
+			if (ringSmall.read(0, dataSmall)) {
+				ringSmall.release(0);
+			}
+		}
+	});
+	for (int idx = 0; idx < 100; idx++) {
+		VERIFY(ringSmall.publish(idx % 2 ? docLarge : docSmall));
+	}
+	ringSmall.close();
+	consumerSmall.join();
+}
+
+/*
+* Test 25: store, round trip through close and open, recovery of a cut off record, orphan segment of a crash, compaction
+*/
+void removeStore(const std::string& directory) {
+	std::remove((directory + "/store.pye").c_str());
+	std::remove((directory + "/store.pye.new").c_str());
+	for (int id = 1; id < 1000; id++) {
+		char name[32];
+		snprintf(name, sizeof(name), "/%08u.pyeseg", id);
+		std::remove((directory + name).c_str());
+	}
+	RemoveDirectoryA(directory.c_str());
+}
+
+void testStoreRecovery() {
+	const std::string directory = "./pyeKVS.store";
+	removeStore(directory);
+	VERIFY(CreateDirectoryA(directory.c_str(), NULL));
+
+	PyeStoreOptions options;
+	options.sizeSegment = 1024;
+	options.ratioStaleCompaction = 0;
+
+	PyeStore store;
+	VERIFY(store.open(directory, options));
+	for (int idx = 0; idx < 100; idx++) {
+		PyeDocument doc;
+		doc.getRoot().putInt32(idx, "value");
+		VERIFY(store.put("key" + std::to_string(idx), doc));
+	}
+	for (int idx = 0; idx < 100; idx += 10) {
+		VERIFY(store.remove("key" + std::to_string(idx)));
+	}
+	PyeDocument docReplaced;
+	docReplaced.getRoot().putInt32(-1, "value");
+	VERIFY(store.put("key1", docReplaced));
+	VERIFY(store.getCount() == 90 && store.getCountSegments() > 1);
+	store.close();
+
+	// round trip: the index is recovered from the segments
+	VERIFY(store.open(directory, options));
+	VERIFY(store.getCount() == 90 && !store.contains("key10"));
+	std::vector<unsigned char> value;
+	VERIFY(store.get("key1", value) && PyeDocumentView(&value).getRoot().getInt32("value", 0) == -1);
+	VERIFY(store.get("key99", value) && PyeDocumentView(&value).getRoot().getInt32("value", 0) == 99);
+	size_t countSegments = store.getCountSegments();
+	store.close();
+	VERIFY(!std::ifstream(directory + "/store.pye.new"));
+
+	// a record cut off by a crash at the end of the last segment is ignored
+	char name[32];
+	snprintf(name, sizeof(name), "/%08u.pyeseg", (unsigned int)countSegments);
+	{
+		std::ofstream segment(directory + name, std::ios::binary | std::ios::app);
+		segment.write("PYES\x01\x00\x00\x00\xff\x00\x00\x00\x00\x00\x00\x00", 16);
+	}
+	// a segment file of a crash before the manifest was written is not truncated
+	snprintf(name, sizeof(name), "/%08u.pyeseg", (unsigned int)countSegments + 1);
+	{
+		std::ofstream orphan(directory + name, std::ios::binary);
+		orphan.write("orphan", 6);
+	}
+
+	VERIFY(store.open(directory, options));
+	VERIFY(store.getCount() == 90);
+	VERIFY(store.get("key98", value) && PyeDocumentView(&value).getRoot().getInt32("value", 0) == 98);
+	VERIFY(store.put("key100", docReplaced));
+	VERIFY(store.get("key100", value) && PyeDocumentView(&value).getRoot().getInt32("value", 0) == -1);
+	std::ifstream orphan(directory + name, std::ios::binary | std::ios::ate);
+	VERIFY(orphan && orphan.tellg() == 6);
+	orphan.close();
+
+	// compaction removes the stale records and keeps the live ones over the next open
+	VERIFY(store.getSizeStale() > 0);
+	countSegments = store.getCountSegments();
+	VERIFY(store.compact());
+	VERIFY(store.getCountSegments() < countSegments);
+	store.close();
+	VERIFY(store.open(directory, options));
+	VERIFY(store.getCount() == 91);
+	VERIFY(store.get("key55", value) && PyeDocumentView(&value).getRoot().getInt32("value", 0) == 55);
+
+	// a compaction of the user waits for the background compaction
+	for (int round = 0; round < 5; round++) {
+		for (int idx = 0; idx < 100; idx++) {
+			PyeDocument doc;
+			doc.getRoot().putInt32(round * 1000 + idx, "value");
+			VERIFY(store.put("key" + std::to_string(idx), doc));
+		}
+		store.startCompaction();
+		std::thread compaction([&store]() {
+			VERIFY(store.compact());
+		});
+		VERIFY(store.compact());
+		compaction.join();
+		store.waitCompaction();
+	}
+	store.close();
+	VERIFY(store.open(directory, options));
+	VERIFY(store.getCount() == 101);
+	VERIFY(store.get("key42", value) && PyeDocumentView(&value).getRoot().getInt32("value", 0) == 4042);
+	store.close();
+
+	// a damaged count of segments in the manifest is rejected
+	PyeDocument manifest;
+	PyeArray segments = manifest.getRoot().putArray("segments", pyeValueType::pyeUInt32);
+	segments.putUInt32(1);
+	const unsigned char* data;
+	unsigned __int32 count;
+	pyeValueType arrayType;
+	VERIFY(PyeDocumentView(manifest).getRoot().getArrayData("segments", data, count, arrayType) && count == 1);
+	std::vector<unsigned char> manifestDamaged(*manifest.getBuffer());
+	unsigned __int32 countDamaged = 0x10000000;
+	memcpy(&manifestDamaged[data - manifest.getBuffer()->data() - sizeof(countDamaged)], &countDamaged, sizeof(countDamaged));
+	{
+		std::ofstream file(directory + "/store.pye", std::ios::binary | std::ios::trunc);
+		file.write((const char*)manifestDamaged.data(), manifestDamaged.size());
+	}
+	VERIFY(!store.open(directory, options));
+
+	removeStore(directory);
+}
+
+/*
+* Test 26: store, throughput of put, get and delete
+*/
+void testStoreThroughput() {
+	const std::string directory = "./pyeKVS.store";
+	removeStore(directory);
+	VERIFY(CreateDirectoryA(directory.c_str(), NULL));
+
+	PyeStoreOptions options;
+	options.flushEachWrite = false;
+	PyeStore store;
+	VERIFY(store.open(directory, options));
+
+	const int count = 20000;
+	PyeDocument doc;
+	doc.getRoot().putInt32(1, "id");
+	doc.getRoot().putStringS("payload of the benchmark", "text");
+
+	auto start = std::chrono::steady_clock::now();
+	for (int idx = 0; idx < count; idx++) {
+		VERIFY(store.put("key" + std::to_string(idx), doc));
+	}
+	auto put = std::chrono::steady_clock::now();
+
+	std::vector<unsigned char> value;
+	for (int idx = 0; idx < count; idx++) {
+		VERIFY(store.get("key" + std::to_string(idx), value) && value.size() == doc.getBuffer()->size());
+	}
+	auto get = std::chrono::steady_clock::now();
+
+	for (int idx = 0; idx < count; idx++) {
+		VERIFY(store.remove("key" + std::to_string(idx)));
+	}
+	auto end = std::chrono::steady_clock::now();
+	VERIFY(store.getCount() == 0);
+
+	TRACE("PyeStore put:    %.0f ops/s\n", count / std::chrono::duration<double>(put - start).count());
+	TRACE("PyeStore get:    %.0f ops/s\n", count / std::chrono::duration<double>(get - put).count());
+	TRACE("PyeStore delete: %.0f ops/s\n", count / std::chrono::duration<double>(end - get).count());
+
+	store.close();
+	removeStore(directory);
+}
+
+/*
+* Test 27: write-ahead log, group commit of several threads, replay after close, recovery of a cut off record, checkpoint
+*/
+void removeLog(const std::string& directory) {
+	std::remove((directory + "/snapshot.pye").c_str());
+	std::remove((directory + "/snapshot.pye.new").c_str());
+	std::remove((directory + "/log.pyelog").c_str());
+	std::remove((directory + "/log.pyelog.new").c_str());
+	RemoveDirectoryA(directory.c_str());
+}
+
+void testWriteAheadLog() {
+	const std::string directory = "./pyeKVS.log";
+	removeLog(directory);
+	VERIFY(CreateDirectoryA(directory.c_str(), NULL));
+
+	PyeLogOptions options;
+	options.delayGroup = 100;
+
+	PyeDocument doc;
+	doc.getRoot().putInt32(0, "count");
+	PyeWriteAheadLog log;
+	VERIFY(log.open(directory, doc, options));
+
+	std::mutex mutexDoc;
+	std::thread writers[4];
+	for (int thread = 0; thread < 4; thread++) {
+		writers[thread] = std::thread([&log, &doc, &mutexDoc, thread]() {
+			for (int idx = 0; idx < 25; idx++) {
+				PyeUpdate update;
+				update.put(PyeKeyPath{ "key" + std::to_string(thread * 100 + idx) }, (__int32)idx);
+				VERIFY(log.commit(update) != 0);
+
+				std::lock_guard<std::mutex> lock(mutexDoc);
+				doc = update.apply(doc);
+			}
+		});
+	}
+	for (std::thread& writer : writers) {
+		writer.join();
+	}
+	VERIFY(log.getSequence() == 100 && log.getSequenceWritten() == 100);
+	VERIFY(log.getCountWrites() <= 100);
+	log.close();
+
+	// round trip: the records are replayed on the initial document
+	PyeDocument docBack;
+	docBack.getRoot().putInt32(0, "count");
+	VERIFY(log.open(directory, docBack, options));
+	VERIFY(log.getSequence() == 100);
+	PyeDocumentView viewBack(docBack.getBuffer());
+	VERIFY(viewBack.getRoot().getInt32("key324", -1) == 24 && viewBack.getRoot().getInt32("key0", -1) == 0);
+	VERIFY(PyeDiff::diff(doc, docBack).getRoot().getCount() == 0);
+
+	PyeUpdate update;
+	update.put(PyeKeyPath{ "count" }, (__int32)1);
+	update.remove(PyeKeyPath{ "key0" });
+	VERIFY(log.commit(update) == 101);
+	log.close();
+
+	// a record cut off by a crash is removed, the records before stay
+	{
+		std::ofstream file(directory + "/log.pyelog", std::ios::binary | std::ios::app);
+		file.write("PYES\x01\x00\x00\x00\xff\x00\x00\x00\x00\x00\x00\x00", 16);
+	}
+	PyeDocument docRecovered;
+	docRecovered.getRoot().putInt32(0, "count");
+	VERIFY(log.open(directory, docRecovered, options));
+	VERIFY(log.getSequence() == 101);
+	PyeDocumentView viewRecovered(docRecovered.getBuffer());
+	VERIFY(viewRecovered.getRoot().getInt32("count", -1) == 1 && !viewRecovered.getRoot().hasKey("key0"));
+
+	// checkpoint: the snapshot replaces the initial document and the records
+	VERIFY(log.checkpoint(docRecovered, log.getSequence()));
+	log.close();
+	std::ifstream logFile(directory + "/log.pyelog", std::ios::binary | std::ios::ate);
+	VERIFY(logFile && logFile.tellg() == 0);
+	logFile.close();
+
+	PyeDocument docSnapshot;
+	VERIFY(log.open(directory, docSnapshot, options));
+	VERIFY(log.getSequence() == 101);
+	PyeDocumentView viewSnapshot(docSnapshot.getBuffer());
+	VERIFY(viewSnapshot.getRoot().getInt32("count", -1) == 1 && !viewSnapshot.getRoot().hasKey("key0"));
+	VERIFY(viewSnapshot.getRoot().getInt32("key124", -1) == 24 && viewSnapshot.getRoot().getInt32("key324", -1) == 24);
+	log.close();
+
+	removeLog(directory);
+}
+
+/*
+* Test 28: versioned document, pinned versions of readers during updates, publish of a stale base, recovery with log and checkpoints
+*/
+void testVersionedDocument() {
+	PyeVersionedDocument versioned;
+	PyeVersionPin pinEmpty = versioned.pin();
+	VERIFY(pinEmpty->getNumber() == 0);
+
+	PyeDocument doc = pinEmpty->copy();
+	doc.getRoot().putInt32(0, "a");
+	doc.getRoot().putInt32(0, "b");
+	VERIFY(versioned.publish(doc, 0) == 1);
+	PyeDocument docStale;
+	VERIFY(versioned.publish(docStale, 0) == 0);
+	VERIFY(pinEmpty->getView().getRoot().getCount() == 0 && versioned.getNumber() == 1);
+
+	// readers never see a version, in which only one of the two objects is updated
+	std::atomic<bool> stop{ false };
+	std::thread reader([&versioned, &stop]() {
+		while (!stop.load()) {
+			PyeVersionPin pin = versioned.pin();
+			PyeDocumentView view = pin->getView();
+			VERIFY(view.getRoot().getInt32("a", -1) == view.getRoot().getInt32("b", -2));
+		}
+	});
+	for (__int32 idx = 1; idx <= 200; idx++) {
+		PyeUpdate update;
+		update.put(PyeKeyPath{ "a" }, idx);
+		update.put(PyeKeyPath{ "b" }, idx);
+		VERIFY(versioned.update(update) != 0);
+	}
+	stop.store(true);
+	reader.join();
+	VERIFY(versioned.getNumber() == 201 && versioned.pin()->getView().getRoot().getInt32("a", -1) == 200);
+
+	// round trip through a write-ahead log with background checkpoints
+	const std::string directory = "./pyeKVS.log";
+	removeLog(directory);
+	VERIFY(CreateDirectoryA(directory.c_str(), NULL));
+
+	PyeWriteAheadLog log;
+	PyeDocument docLog;
+	VERIFY(log.open(directory, docLog));
+	VERIFY(versioned.restore(docLog, log) == 202 && versioned.pin()->getView().getRoot().getCount() == 0);
+	versioned.startCheckpoints(log, 5);
+	for (__int32 idx = 1; idx <= 50; idx++) {
+		PyeUpdate update;
+		update.put(PyeKeyPath{ "a" }, idx);
+		update.put(PyeKeyPath{ "key" + std::to_string(idx) }, idx);
+		VERIFY(versioned.update(update, &log) != 0);
+		if (idx == 25) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+	}
+	// a publish with the log is committed as patch like an update
+	PyeVersionPin pinBase = versioned.pin();
+	PyeDocument docPublished = pinBase->copy();
+	docPublished.getRoot().putInt32(1, "published");
+	VERIFY(versioned.publish(docPublished, pinBase->getNumber(), &log) == pinBase->getNumber() + 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	versioned.stopCheckpoints();
+	VERIFY(versioned.pin()->getSequence() == 51);
+	log.close();
+
+	PyeVersionedDocument versionedBack;
+	PyeDocument docBack;
+	VERIFY(log.open(directory, docBack));
+	VERIFY(log.getSequence() == 51);
+	versionedBack.restore(docBack, log);
+	PyeDocumentView viewBack = versionedBack.pin()->getView();
+	VERIFY(viewBack.getRoot().getInt32("a", -1) == 50 && viewBack.getRoot().getInt32("key1", -1) == 1);
+	VERIFY(viewBack.getRoot().getInt32("published", -1) == 1 && viewBack.getRoot().getCount() == 52);
+	VERIFY(versionedBack.checkpoint(log));
+	log.close();
+
+	removeLog(directory);
+}
+
+/*
+* Test 29: cache of the decoded containers, shared by the views of two byte streams, rows of a pyeArrayMap, views of a byte span
+*/
+void testContainerCache() {
+	std::vector<pyeValueType> mapStruct{ pyeValueType::pyeInt32, pyeValueType::pyeStringUTF8S };
+
+	// two documents with containers at the same offsets
+	PyeDocument docs[2];
+	for (int idxDoc = 0; idxDoc < 2; idxDoc++) {
+		PyeList list = docs[idxDoc].getRoot().putList("list");
+		list.putInt32(idxDoc, "doc");
+		PyeArrayMap arrayMap = docs[idxDoc].getRoot().putArrayMap("rows", mapStruct);
+		for (int row = 0; row < 100; row++) {
+			arrayMap.putInt32(row * (idxDoc + 1));
+			arrayMap.putStringS(std::string(row % 7, 'x'));
+		}
+	}
+
+	std::shared_ptr<PyeContainerCache> cache = std::make_shared<PyeContainerCache>(1 << 20);
+	for (int idxDoc = 0; idxDoc < 2; idxDoc++) {
+		PyeDocumentView view(docs[idxDoc].getBuffer(), nullptr, cache);
+		VERIFY(view.getRoot().getList("list").getInt32("doc", -1) == idxDoc);
+
+		PyeArrayMap arrayMap(nullptr, 0);
+		VERIFY(view.getRoot().getArrayMap("rows", arrayMap));
+		VERIFY(arrayMap.getInt32(99, 0) == 99 * (idxDoc + 1));
+		VERIFY(arrayMap.getStringS(99, 1) == std::string(99 % 7, 'x'));
+	}
+	VERIFY(cache->getCountMisses() == 6 && cache->getCount() == 6);
+
+	// a second view of the first document takes the containers from the cache
+	PyeDocumentView viewAgain(docs[0].getBuffer(), nullptr, cache);
+	PyeArrayMap arrayMapAgain(nullptr, 0);
+	VERIFY(viewAgain.getRoot().getArrayMap("rows", arrayMapAgain) && arrayMapAgain.getInt32(50, 0) == 50);
+	VERIFY(cache->getCountHits() == 2 && cache->getCountMisses() == 6);
+
+	// a view of a byte span uses the cache for its lists; a pyeArrayMap needs a std::vector
+	std::vector<unsigned char> memory(*docs[1].getBuffer());
+	PyeDocumentView viewSpan(memory.data(), memory.size(), nullptr, cache);
+	VERIFY(viewSpan.getRoot().getList("list").getInt32("doc", -1) == 1);
+	VERIFY(!viewSpan.getRoot().getArrayMap("rows", arrayMapAgain));
+	VERIFY(cache->getCount() == 8);
+
+	// a literal nullptr selects the constructors without index and cache
+	PyeDocumentView viewNull(memory.data(), memory.size(), nullptr);
+	PyeListView listNull(&memory, 16, nullptr);
+	VERIFY(viewNull.getRoot().getCount() == 2 && listNull.getCount() == 2);
+
+	cache->clear();
+	VERIFY(cache->getCount() == 0 && cache->getSize() == 0);
+}
+
+/*
+* Test 30: getters of the view check the stored pye value type and the length of strings and memory
+*/
+void testViewTypes() {
+	PyeDocument doc;
+	doc.getRoot().putInt32(7, "int");
+	doc.getRoot().putStringS("short", "stringS");
+	doc.getRoot().putMemory(std::vector<unsigned char>{ 1, 2, 3 }, "memory");
+	doc.getRoot().putStringL("abcdef", "stringL");
+
+	PyeDocumentView view(doc.getBuffer());
+	VERIFY(view.getRoot().getInt32("int", -1) == 7);
+	VERIFY(view.getRoot().getInt64("int", -1) == -1 && view.getRoot().getUInt32("int", 1) == 1);
+	VERIFY(view.getRoot().getDouble("stringS", 2.5) == 2.5);
+	VERIFY(view.getRoot().getStringS("stringS") == "short" && view.getRoot().getStringL("stringS", "none") == "none");
+	VERIFY(view.getRoot().getStringS("stringL", "none") == "none" && view.getRoot().getStringL("stringL") == "abcdef");
+	VERIFY(view.getRoot().getMemory("memory").size() == 3 && view.getRoot().getMemory("stringL").empty());
+
+	// a damaged length of the last value must not read behind the byte span
+	std::vector<unsigned char> memory(*doc.getBuffer());
+	const std::string text = "abcdef";
+	auto found = std::search(memory.begin(), memory.end(), text.begin(), text.end());
+	VERIFY(found != memory.end());
+	unsigned __int32 sizeDamaged = 0x7fffffff;
+	memcpy(&*(found - 4), &sizeDamaged, sizeof(sizeDamaged));
+
+	PyeDocumentView viewSpan(memory.data(), memory.size());
+	VERIFY(viewSpan.getRoot().getStringL("stringL", "damaged") == "damaged");
+	VERIFY(viewSpan.getRoot().getStringS("stringS") == "short");
+}
+
+/*
+* Test 31: JSON output of lists with reserved objects (key directory), parsed back
+*/
+bool parseJSONObject(const std::string& text, size_t& pos);
+
+void skipJSONSpace(const std::string& text, size_t& pos) {
+	while (pos < text.size() && isspace((unsigned char)text[pos])) {
+		pos++;
+	}
+}
+
+bool parseJSONString(const std::string& text, size_t& pos) {
+	if (pos >= text.size() || text[pos] != '"') {
+		return false;
+	}
+	size_t end = text.find('"', pos + 1);
+	if (end == std::string::npos) {
+		return false;
+	}
+	pos = end + 1;
+	return true;
+}
+
+bool parseJSONObject(const std::string& text, size_t& pos) {
+	skipJSONSpace(text, pos);
+	if (pos >= text.size() || text[pos++] != '{') {
+		return false;
+	}
+	skipJSONSpace(text, pos);
+	if (pos < text.size() && text[pos] == '}') {
+		pos++;
+		return true;
+	}
+	for (;;) {
+		skipJSONSpace(text, pos);
+		if (!parseJSONString(text, pos)) {
+			return false;
+		}
+		skipJSONSpace(text, pos);
+		if (pos >= text.size() || text[pos++] != ':') {
+			return false;
+		}
+		skipJSONSpace(text, pos);
+		if (!(pos < text.size() && text[pos] == '{' ? parseJSONObject(text, pos) : parseJSONString(text, pos))) {
+			return false;
+		}
+		skipJSONSpace(text, pos);
+		if (pos >= text.size()) {
+			return false;
+		}
+		if (text[pos] == '}') {
+			pos++;
+			return true;
+		}
+		if (text[pos++] != ',') {
+			return false;
+		}
+	}
+}
+
+void testStringJSON() {
+	PyeTestMessage message = { 7, 1.5, "kg", true };
+
+	PyeDocument doc;
+	PyeList list = doc.getRoot().putList("message");
+	PyeSchemaCodec<PyeTestMessage>::put(list, message);
+	PyeKeyDirectory::put(list);
+	doc.getRoot().putInt32(3, "count");
+	PyeList empty = doc.getRoot().putList("empty");
+	PyeKeyDirectory::put(empty);
+
+	PyeDocument docBack(doc.getBuffer());
+	for (const std::string& separator : { std::string(), std::string("\r\n") }) {
+		std::string json = docBack.toStringJSON(separator, "  ");
+		size_t pos = 0;
+		VERIFY(parseJSONObject(json, pos));
+		skipJSONSpace(json, pos);
+		VERIFY(pos == json.size());
+		VERIFY(json.find("\"unit\"") != std::string::npos && json.find("dir") == std::string::npos);
+	}
+}
+
 CpyeKVScppDlg::CpyeKVScppDlg(CWnd* pParent /*=nullptr*/)
 	: CDialogEx(IDD_PYEKVSCPP_DIALOG, pParent)
 {
@@ -387,6 +1692,38 @@ void CpyeKVScppDlg::OnBnClickedDlgbuttonmemoryhandmade()
 	__int16 int16_3 = pyeDoc.getRoot().getArrayMap("ArrayMap1").getInt16(2, 0);
 	double double_3 = pyeDoc.getRoot().getArrayMap("ArrayMap1").getDouble(2, 1);
 	unsigned __int32 uint32_3 = pyeDoc.getRoot().getArrayMap("ArrayMap1").getUInt32(2, 2);
+
+	/*
+	* Test 4 and up: testbench of the pyeKVS extensions, see above
+	*/
+	testDiffPatch();
+	testMerge();
+	testViewReaders();
+	testParallelIndex();
+	testParallelBuild();
+	testSchema();
+	testTypedPutGet();
+	testSchemaRows();
+	testColumnMap();
+	testScan();
+	testColumnIndex();
+	testKeyDirectory();
+	testPerfectHash();
+	testBlockCompression();
+	testNumericArray();
+	testInternedKeys();
+	testValue128();
+	testBufferPool();
+	testSpanView();
+	testSharedMemory();
+	testRingBuffer();
+	testStoreRecovery();
+	testStoreThroughput();
+	testWriteAheadLog();
+	testVersionedDocument();
+	testContainerCache();
+	testViewTypes();
+	testStringJSON();
 	
 	// finish pye document with handmade data
 